@@ -0,0 +1,41 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "maze.h"
+#include "pathfinder.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Helpers shared by the benchmarks of maze_bench
+
+// Wall time of fn in milliseconds
+template <class Fn>
+double timeMs(Fn&& fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Calls to global operator new so far, which maze_bench replaces to count
+uint64_t allocationCount();
+
+// Start and end pairs on open cells, the same for a given seed
+std::vector<std::pair<Point, Point>> randomQueries(const Maze& maze,
+                                                   int count,
+                                                   uint32_t seed);
+
+// The benchmarks, each prints its own table
+void benchQueues();
+void benchCosts();
+void benchGenerators();
+void benchRegenerate();
+void benchLayouts();
+void benchRowMajorLayout();
+void benchTiledLayout();
+
+#endif // BENCH_H
@@ -0,0 +1,93 @@
+// Cost-aware A* and Dijkstra on a 4001x4001 grid of scattered walls, 20% of
+// the cells, with random costs 1..9 and the trace off. Every solver answers
+// the same five queries, and their path costs have to match.
+
+#include "bench.h"
+#include "astarpathfinder.h"
+#include "dijkstrapathfinder.h"
+
+#include <cstdio>
+
+namespace
+{
+
+// Open ground with one cell in five a wall, so the searches spread out
+// instead of following corridors
+class ScatteredWalls : public Maze
+{
+public:
+    using Maze::Maze;
+
+protected:
+    void onGenerate() override
+    {
+        for (int y = 0; y < (int)getHeight(); y++)
+        {
+            for (int x = 0; x < (int)getWidth(); x++)
+            {
+                if (m_rng() % 5 != 0)
+                    setWall(x, y, false);
+            }
+        }
+    }
+};
+
+uint64_t pathCost(const Maze& maze, const std::vector<Point>& path)
+{
+    uint64_t cost = 0;
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        cost += maze.getCost(path[i].x, path[i].y);
+    }
+    return cost;
+}
+
+} // namespace
+
+void benchCosts()
+{
+    auto maze = std::make_shared<ScatteredWalls>(4001, 4001);
+    maze->generate(1);
+    maze->randomizeCosts(9, 1);
+
+    constexpr int queries = 5;
+    auto pairs = randomQueries(*maze, queries, 1);
+
+    AStarPathFinder heap(AStarPathFinder::QueueType::BinaryHeap);
+    AStarPathFinder buckets(AStarPathFinder::QueueType::Buckets);
+    DijkstraPathFinder dijkstra;
+
+    struct Entry
+    {
+        const char* name;
+        PathFinder* finder;
+        uint64_t cost;
+    };
+    Entry entries[] =
+    {
+        { "A* (heap)", &heap, 0 },
+        { "A* (buckets)", &buckets, 0 },
+        { "Dijkstra", &dijkstra, 0 },
+    };
+
+    for (Entry& entry : entries)
+    {
+        entry.finder->setMaze(maze);
+        entry.finder->setTraceEnabled(false);
+        entry.finder->findPath(pairs[0].first, pairs[0].second);
+
+        double ms = timeMs([&]
+        {
+            for (const auto& [start, end] : pairs)
+            {
+                entry.cost += pathCost(*maze, entry.finder->findPath(start, end).first);
+            }
+        });
+
+        std::printf("%-13s %7.1f ms/query  total cost %llu\n",
+                    entry.name, ms / queries, (unsigned long long)entry.cost);
+    }
+
+    bool same = entries[0].cost == entries[1].cost && entries[1].cost == entries[2].cost;
+    std::printf("%s\n", same ? "Path costs match" : "PATH COSTS DIFFER");
+}
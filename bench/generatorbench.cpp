@@ -0,0 +1,32 @@
+// Wilson's algorithm against Kruskal's on 4001x4001 mazes. The first
+// generate() grows the maze's buffers, the best of the next three reuses
+// them. Neither builds the tree index, which waits for its first query.
+
+#include "bench.h"
+#include "kruskalmaze.h"
+#include "wilsonmaze.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static void timeGenerator(const char* name, Maze& maze)
+{
+    double first = timeMs([&] { maze.generate(1); });
+
+    double best = 1e30;
+    for (uint32_t seed = 2; seed <= 4; seed++)
+    {
+        best = std::min(best, timeMs([&] { maze.generate(seed); }));
+    }
+
+    std::printf("%-8s first %7.0f ms  reused best %7.0f ms\n", name, first, best);
+}
+
+void benchGenerators()
+{
+    WilsonMaze wilson(4001, 4001);
+    timeGenerator("Wilson", wilson);
+
+    KruskalMaze kruskal(4001, 4001);
+    timeGenerator("Kruskal", kruskal);
+}
@@ -0,0 +1,178 @@
+// Row-major and tiled wall layouts on an 8193x8193 Kruskal maze with braid
+// 0.3, the trace off. Solve times are the best of 3.
+//
+// Miss rates come from replaying the wall reads of a full BFS through a
+// model of a 32 KB, 8-way L1 with 64 byte lines and LRU replacement, which
+// needs no perf. Hardware counts come from running one layout on its own:
+//   perf stat -e L1-dcache-loads,L1-dcache-load-misses ./maze_bench layout-rowmajor
+//   perf stat -e L1-dcache-loads,L1-dcache-load-misses ./maze_bench layout-tiled
+// Those include the generator and the solvers' scratch arrays.
+
+#include "bench.h"
+#include "astarpathfinder.h"
+#include "bfspathfinder.h"
+#include "kruskalmaze.h"
+#include "scratcharena.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+
+class CacheModel
+{
+public:
+    CacheModel()
+    {
+        for (auto& set : m_lines)
+            std::fill(std::begin(set), std::end(set), UINT64_MAX);
+    }
+
+    void access(const void* address)
+    {
+        uint64_t line = (uintptr_t)address >> 6;
+        uint64_t* set = m_lines[line % s_sets];
+        m_accesses++;
+
+        // Most recently used first
+        uint64_t* hit = std::find(set, set + s_ways, line);
+        if (hit == set + s_ways)
+        {
+            m_misses++;
+            hit = set + s_ways - 1;
+            *hit = line;
+        }
+        std::rotate(set, hit, hit + 1);
+    }
+
+    uint64_t getAccesses() const { return m_accesses; }
+    double getMissRate() const { return m_accesses ? (double)m_misses / m_accesses : 0.0; }
+
+private:
+    static constexpr int s_ways = 8;
+    static constexpr int s_sets = 32 * 1024 / 64 / s_ways;
+
+    uint64_t m_lines[s_sets][s_ways];
+    uint64_t m_accesses = 0;
+    uint64_t m_misses = 0;
+};
+
+// Grid policy that reads through the layout's own one and hands the model
+// every word it reads
+struct RecordingGrid
+{
+    const Maze& maze;
+    CacheModel& cache;
+
+    const uint64_t* word(int x, int y) const
+    {
+        if (maze.getLayout() == Maze::Layout::Tiled)
+            return maze.getTileWords() + (ptrdiff_t)(y >> 3) * maze.getTilesPerRow() + (x >> 3);
+        return maze.getWords() + (ptrdiff_t)y * maze.getRowWords() + (x >> 6);
+    }
+
+    bool wall(int x, int y) const
+    {
+        cache.access(word(x, y));
+        if (maze.getLayout() == Maze::Layout::Tiled)
+            return SolverCore::TiledGrid(maze).wall(x, y);
+        return SolverCore::RowMajorGrid(maze).wall(x, y);
+    }
+
+    uint8_t openSides(int x, int y) const
+    {
+        uint8_t walls = wall(x, y + 1) |
+                        wall(x + 1, y) << 1 |
+                        wall(x, y - 1) << 2 |
+                        wall(x - 1, y) << 3;
+        return ~walls & 0xf;
+    }
+};
+
+std::shared_ptr<Maze> createMaze()
+{
+    auto maze = std::make_shared<KruskalMaze>(8193, 8193);
+    maze->setBraidRatio(0.3f);
+    maze->generate(1);
+    return maze;
+}
+
+double missRate(const Maze& maze)
+{
+    CacheModel cache;
+    SolverCore::Uninformed<false> bfs;
+
+    // An end no cell matches, so the search visits every reachable cell
+    bfs.begin(maze, 0, SolverCore::invalidCell);
+    SolverCore::NoTrace trace;
+    bfs.run(RecordingGrid{maze, cache}, SolverCore::SquareMoves<4>(), SolverCore::UnitCost(),
+            trace, [] { return false; }, UINT64_MAX);
+
+    return cache.getMissRate();
+}
+
+void printSolveTimes(const std::shared_ptr<Maze>& maze, const char* name)
+{
+    int last = (int)maze->getWidth() - 1;
+
+    BFSPathFinder bfs;
+    AStarPathFinder astar;
+    double ms[2] = { 1e30, 1e30 };
+    PathFinder* finders[2] = { &bfs, &astar };
+    for (int i = 0; i < 2; i++)
+    {
+        finders[i]->setMaze(maze);
+        finders[i]->setTraceEnabled(false);
+        for (int run = 0; run < 3; run++)
+        {
+            ms[i] = std::min(ms[i], timeMs([&]
+            {
+                // BFS corner to corner, A* across the other diagonal
+                if (i == 0)
+                    finders[i]->findPath({0, 0}, {last, last});
+                else
+                    finders[i]->findPath({last, 0}, {0, last});
+            }));
+        }
+    }
+
+    std::printf("%-9s BFS %7.0f ms  A* %7.0f ms\n", name, ms[0], ms[1]);
+}
+
+void benchLayout(bool tiled)
+{
+    // Every run from a warm arena, not a fresh mapping of its scratch
+    ScratchArena::local().setRetainLimit(SIZE_MAX);
+
+    auto maze = createMaze();
+    maze->setLayout(tiled ? Maze::Layout::Tiled : Maze::Layout::RowMajor);
+    printSolveTimes(maze, tiled ? "tiled" : "row-major");
+}
+
+} // namespace
+
+void benchLayouts()
+{
+    ScratchArena::local().setRetainLimit(SIZE_MAX);
+
+    auto maze = createMaze();
+    for (Maze::Layout layout : { Maze::Layout::RowMajor, Maze::Layout::Tiled })
+    {
+        maze->setLayout(layout);
+        const char* name = layout == Maze::Layout::Tiled ? "tiled" : "row-major";
+        std::printf("%-9s modelled L1 misses %5.1f%% of the BFS wall reads\n",
+                    name, missRate(*maze) * 100.0);
+        printSolveTimes(maze, name);
+    }
+}
+
+void benchRowMajorLayout()
+{
+    benchLayout(false);
+}
+
+void benchTiledLayout()
+{
+    benchLayout(true);
+}
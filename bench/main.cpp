@@ -0,0 +1,113 @@
+// Benchmarks of the mazes and solvers, built only on request. Runs every
+// benchmark, or those named on the command line. Some only run when named.
+
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+static std::atomic<uint64_t> s_allocations{0};
+
+void* operator new(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+struct Benchmark
+{
+    const char* name;
+    const char* description;
+    void (*run)();
+    bool onRequest; // Left out of a run of them all
+};
+
+static const Benchmark s_benchmarks[] =
+{
+    { "queues", "A* with a bucket queue vs a binary heap, 2001x2001", benchQueues, false },
+    { "costs", "Cost-aware A* vs Dijkstra, weighted 4001x4001", benchCosts, false },
+    { "generators", "Wilson vs Kruskal generation, 4001x4001", benchGenerators, false },
+    { "regenerate", "Regenerating 10k 101x101 mazes, new vs reused", benchRegenerate, false },
+    { "layout", "Row-major vs tiled walls, miss rates and solves, 8193x8193", benchLayouts, false },
+    { "layout-rowmajor", "Solves on row-major walls alone, for perf stat", benchRowMajorLayout, true },
+    { "layout-tiled", "Solves on tiled walls alone, for perf stat", benchTiledLayout, true },
+};
+
+uint64_t allocationCount()
+{
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+std::vector<std::pair<Point, Point>> randomQueries(const Maze& maze,
+                                                   int count,
+                                                   uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> x(0, (int)maze.getWidth() - 1);
+    std::uniform_int_distribution<int> y(0, (int)maze.getHeight() - 1);
+
+    auto openCell = [&]()
+    {
+        Point p;
+        do
+        {
+            p = Point{x(rng), y(rng)};
+        } while (maze.isWall(p.x, p.y));
+        return p;
+    };
+
+    std::vector<std::pair<Point, Point>> queries;
+    for (int i = 0; i < count; i++)
+    {
+        Point start = openCell();
+        queries.push_back({start, openCell()});
+    }
+    return queries;
+}
+
+int main(int argc, char** argv)
+{
+    bool ran = false;
+    for (const Benchmark& benchmark : s_benchmarks)
+    {
+        bool selected = argc == 1 && !benchmark.onRequest;
+        for (int i = 1; i < argc; i++)
+        {
+            selected |= std::strcmp(argv[i], benchmark.name) == 0;
+        }
+
+        if (!selected)
+            continue;
+
+        std::cout << "== " << benchmark.name << ": " << benchmark.description << std::endl;
+        benchmark.run();
+        ran = true;
+    }
+
+    if (!ran)
+    {
+        std::cerr << "Unknown benchmark, the benchmarks are:" << std::endl;
+        for (const Benchmark& benchmark : s_benchmarks)
+        {
+            std::cerr << "  " << benchmark.name << "  " << benchmark.description << std::endl;
+        }
+        return 1;
+    }
+
+    return 0;
+}
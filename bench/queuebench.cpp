@@ -0,0 +1,53 @@
+// A* with its two open sets on 2001x2001 mazes, the trace off. The times
+// include resetting the per-cell scratch arrays.
+
+#include "bench.h"
+#include "astarpathfinder.h"
+#include "kruskalmaze.h"
+#include "primmaze.h"
+
+#include <cstdio>
+
+static void compareQueues(const char* name, const std::shared_ptr<Maze>& maze)
+{
+    constexpr int queries = 20;
+    auto pairs = randomQueries(*maze, queries, 1);
+
+    AStarPathFinder heap(AStarPathFinder::QueueType::BinaryHeap);
+    AStarPathFinder buckets(AStarPathFinder::QueueType::Buckets);
+
+    double ms[2] = {};
+    size_t length[2] = {};
+    AStarPathFinder* finders[2] = { &heap, &buckets };
+    for (int i = 0; i < 2; i++)
+    {
+        finders[i]->setMaze(maze);
+        finders[i]->setTraceEnabled(false);
+
+        // Warm the scratch arena so neither pays for growing it
+        finders[i]->findPath(pairs[0].first, pairs[0].second);
+
+        ms[i] = timeMs([&]
+        {
+            for (const auto& [start, end] : pairs)
+            {
+                length[i] += finders[i]->findPath(start, end).first.size();
+            }
+        });
+    }
+
+    std::printf("%-8s heap %7.1f ms/query  buckets %7.1f ms/query  %s\n",
+                name, ms[0] / queries, ms[1] / queries,
+                length[0] == length[1] ? "same lengths" : "LENGTHS DIFFER");
+}
+
+void benchQueues()
+{
+    auto kruskal = std::make_shared<KruskalMaze>(2001, 2001);
+    kruskal->generate(1);
+    compareQueues("Kruskal", kruskal);
+
+    auto prim = std::make_shared<PrimMaze>(2001, 2001);
+    prim->generate(1);
+    compareQueues("Prim", prim);
+}
@@ -0,0 +1,73 @@
+// 10k regenerations of a 101x101 maze per generator, each followed by the
+// tree index build its first query would do. The allocating loop makes a
+// new maze every time. The reusing one generates into a back buffer and
+// swaps it with the front, as the visualizer does, so both keep their
+// buffers.
+
+#include "bench.h"
+#include "binarytreemaze.h"
+#include "ellermaze.h"
+#include "kruskalmaze.h"
+#include "primmaze.h"
+#include "recursivebacktrackingmaze.h"
+#include "sidewindermaze.h"
+#include "wilsonmaze.h"
+
+#include <cstdio>
+#include <utility>
+
+template <class Generator>
+static void compareRegenerate(const char* name)
+{
+    constexpr int count = 10000;
+    constexpr uint32_t size = 101;
+
+    uint64_t before = allocationCount();
+    double allocatingMs = timeMs([&]
+    {
+        for (int i = 0; i < count; i++)
+        {
+            auto maze = std::make_shared<Generator>(size, size);
+            maze->generate(i + 1);
+            maze->getTreeIndex();
+        }
+    });
+    uint64_t allocating = allocationCount() - before;
+
+    auto front = std::make_shared<Generator>(size, size);
+    auto back = std::make_shared<Generator>(size, size);
+    for (auto& maze : { front, back })
+    {
+        maze->generate(0);
+        maze->getTreeIndex();
+    }
+
+    before = allocationCount();
+    double reusingMs = timeMs([&]
+    {
+        for (int i = 0; i < count; i++)
+        {
+            back->generate(i + 1);
+            back->getTreeIndex();
+            std::swap(front, back);
+        }
+    });
+    uint64_t reusing = allocationCount() - before;
+
+    std::printf("%-22s allocating %7.0f mazes/s %5.1f allocations/maze"
+                "  reusing %7.0f mazes/s %5.1f allocations/maze\n",
+                name,
+                count / allocatingMs * 1000.0, (double)allocating / count,
+                count / reusingMs * 1000.0, (double)reusing / count);
+}
+
+void benchRegenerate()
+{
+    compareRegenerate<RecursiveBacktrackingMaze>("Recursive backtracking");
+    compareRegenerate<KruskalMaze>("Kruskal");
+    compareRegenerate<PrimMaze>("Prim");
+    compareRegenerate<EllerMaze>("Eller");
+    compareRegenerate<SidewinderMaze>("Sidewinder");
+    compareRegenerate<BinaryTreeMaze>("Binary tree");
+    compareRegenerate<WilsonMaze>("Wilson");
+}
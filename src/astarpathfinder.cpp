@@ -1,70 +1,55 @@
 #include "astarpathfinder.h"
 
-#include <queue>
-
-AStarPathFinder::AStarPathFinder() {}
+AStarPathFinder::AStarPathFinder(QueueType queueType)
+    : m_queueType(queueType)
+{}
 
 std::pair<std::vector<Point>, std::vector<IterationData>>
 AStarPathFinder::findPath(Point start, Point end)
 {
-    auto comp = [](const std::pair<int, Point>& a,
-                   const std::pair<int, Point>& b)
-    {
-        return a.first > b.first;
-    };
-
-    std::priority_queue<std::pair<int, Point>,
-                        std::vector<std::pair<int, Point>>,
-                        decltype(comp)> openSet(comp);
-
-    std::unordered_map<Point, Point, PointHash> cameFrom;
-    std::unordered_map<Point, int, PointHash> gScore;
-
-    openSet.push({0, start});
-    gScore[start] = 0;
-
-    std::vector<IterationData> iterData;
-
-    while (!openSet.empty())
-    {
-        IterationData it;
-
-        Point current = openSet.top().second;
-        openSet.pop();
-        it.currentPoint = current;
+    if (m_queueType == QueueType::Buckets)
+        return findCorePath<BucketSearch>(start, end);
+    return findCorePath<HeapSearch>(start, end);
+}
 
-        if (current == end)
-        {
-            return std::make_pair(reconstructPath(cameFrom, current),
-                                  iterData);
-        }
+bool AStarPathFinder::supportsTopology(Maze::Topology) const
+{
+    return true;
+}
 
-        for (const Point& n : getNeighbors(current))
-        {
-            int tentativeGScore = gScore[current] + 1;
+uint64_t AStarPathFinder::getVariant() const
+{
+    return (uint64_t)m_queueType;
+}
 
-            if (gScore.find(n) == gScore.end() ||
-                tentativeGScore < gScore[n])
-            {
-                cameFrom[n] = current;
-                gScore[n] = tentativeGScore;
-                int fScore = tentativeGScore + calculateHeuristic(n, end);
-                openSet.push({fScore, n});
-                it.neighbors[n] = fScore;
-            }
-        }
+bool AStarPathFinder::isResumable() const
+{
+    return true;
+}
 
-        it.path = reconstructPath(cameFrom, current);
+bool AStarPathFinder::onBegin(Point start, Point end)
+{
+    // A queue type set mid-search applies to the next one
+    m_stepQueueType = m_queueType;
+    if (m_stepQueueType == QueueType::Buckets)
+        return beginCoreSteps(m_bucketSearch, start, end);
+    return beginCoreSteps(m_heapSearch, start, end);
+}
 
-        iterData.push_back(it);
-    }
+void AStarPathFinder::onStep(uint64_t maxExpansions)
+{
+    if (m_stepQueueType == QueueType::Buckets)
+        stepCore(m_bucketSearch, maxExpansions);
+    else
+        stepCore(m_heapSearch, maxExpansions);
+}
 
-    return std::make_pair(std::vector<Point>(),
-                          std::vector<IterationData>());
+void AStarPathFinder::setQueueType(QueueType queueType)
+{
+    m_queueType = queueType;
 }
 
-int AStarPathFinder::calculateHeuristic(const Point &a,
-                                        const Point &b) const
+AStarPathFinder::QueueType AStarPathFinder::getQueueType() const
 {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+    return m_queueType;
 }
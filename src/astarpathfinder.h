@@ -2,18 +2,49 @@
 #define ASTARPATHFINDER_H
 
 #include "pathfinder.h"
+#include "bucketqueue.h"
+#include "solvercore.h"
 
 class AStarPathFinder : public PathFinder
 {
 public:
-    AStarPathFinder();
+    enum class QueueType
+    {
+        BinaryHeap,
+        Buckets
+    };
+
+public:
+    AStarPathFinder(QueueType queueType = QueueType::Buckets);
 
     virtual
     std::pair<std::vector<Point>, std::vector<IterationData>>
     findPath(Point start, Point end) override;
 
+    virtual bool supportsTopology(Maze::Topology topology) const override;
+    // The queues break ties between equal f-scores differently
+    virtual uint64_t getVariant() const override;
+
+    virtual bool isResumable() const override;
+
+    void setQueueType(QueueType queueType);
+    QueueType getQueueType() const;
+
+protected:
+    virtual bool onBegin(Point start, Point end) override;
+    virtual void onStep(uint64_t maxExpansions) override;
+
 private:
-    int calculateHeuristic(const Point& a, const Point& b) const;
+    using HeapSearch = SolverCore::BestFirst<SolverCore::HeapQueue, true>;
+    using BucketSearch = SolverCore::BestFirst<BucketQueue, true>;
+
+    QueueType m_queueType;
+
+    // The stepped search, kept between searches to reuse its capacity.
+    // findPath() draws its own from the ScratchArena.
+    HeapSearch m_heapSearch;
+    BucketSearch m_bucketSearch;
+    QueueType m_stepQueueType = QueueType::Buckets; // Queue of the stepped search
 };
 
 #endif // ASTARPATHFINDER_H
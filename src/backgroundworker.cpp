@@ -0,0 +1,81 @@
+#include "backgroundworker.h"
+
+BackgroundWorker::BackgroundWorker()
+    : m_thread(&BackgroundWorker::workerLoop, this)
+{}
+
+BackgroundWorker::~BackgroundWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+bool BackgroundWorker::submit(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_busy)
+            return false;
+
+        m_job = std::move(job);
+        m_busy = true;
+        m_done = false;
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+bool BackgroundWorker::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_busy;
+}
+
+bool BackgroundWorker::poll()
+{
+    Publish publish;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_done)
+            return false;
+
+        publish = std::move(m_publish);
+        m_publish = nullptr;
+        m_done = false;
+    }
+
+    // Still busy while publishing, so the result lands before a new job starts
+    if (publish)
+        publish();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy = false;
+    return true;
+}
+
+void BackgroundWorker::workerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || m_job; });
+            if (m_stop)
+                return;
+
+            job = std::move(m_job);
+            m_job = nullptr;
+        }
+
+        Publish publish = job();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_publish = std::move(publish);
+        m_done = true;
+    }
+}
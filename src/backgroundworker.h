@@ -0,0 +1,48 @@
+#ifndef BACKGROUNDWORKER_H
+#define BACKGROUNDWORKER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs one job at a time on a dedicated thread.
+// A job returns the step that publishes its result. That step only runs on
+// the owner's thread inside poll(), so whatever the UI reads changes between
+// frames and never halfway through one.
+class BackgroundWorker
+{
+public:
+    using Publish = std::function<void()>;
+    using Job = std::function<Publish()>;
+
+public:
+    BackgroundWorker();
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+    // Waits for a running job, its result is dropped
+    ~BackgroundWorker();
+
+    // Returns false while an earlier job has not been published yet
+    bool submit(Job job);
+    // True from submit() until poll() has published the result
+    bool isBusy() const;
+    // Publishes a finished job, meant to be called once per frame.
+    // Returns true if it did.
+    bool poll();
+
+private:
+    void workerLoop();
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    Job m_job;
+    Publish m_publish;
+    bool m_busy = false;
+    bool m_done = false;
+    bool m_stop = false;
+    std::thread m_thread; // Started last, once the state above exists
+};
+
+#endif // BACKGROUNDWORKER_H
@@ -2,6 +2,7 @@
 #define BFSPATHFINDER_H
 
 #include "pathfinder.h"
+#include "solvercore.h"
 
 class BFSPathFinder : public PathFinder
 {
@@ -12,15 +13,18 @@ public:
     std::pair<std::vector<Point>, std::vector<IterationData>>
     findPath(Point start, Point end) override;
 
+    virtual bool supportsTopology(Maze::Topology topology) const override;
+
+    virtual bool isResumable() const override;
+
+protected:
+    virtual bool onBegin(Point start, Point end) override;
+    virtual void onStep(uint64_t maxExpansions) override;
+
 private:
-    // Helper method to check if a point has been visited
-    bool isVisited(const std::unordered_map<Point, Point, PointHash>& visited,
-                   const Point& point) const;
-
-    // Override the base class's reconstructPath for BFS-specific path reconstruction
-    std::vector<Point> reconstructPath(const std::unordered_map<Point, Point, PointHash>& cameFrom,
-                                       Point current,
-                                       Point start) const;
+    // The stepped search, kept between searches to reuse its capacity.
+    // findPath() draws its own from the ScratchArena.
+    SolverCore::Uninformed<false> m_search;
 };
 
 #endif // BFSPATHFINDER_H
@@ -0,0 +1,29 @@
+#include "binarytreemaze.h"
+
+BinaryTreeMaze::BinaryTreeMaze(uint32_t width,
+                               uint32_t height)
+    : Maze(width, height)
+{
+    m_generatorName = "Binary Tree";
+}
+
+void BinaryTreeMaze::onGenerate()
+{
+    int width = getWidth();
+    int height = getHeight();
+
+    for (int y = 0; y < height; y += 2)
+    {
+        for (int x = 0; x < width; x += 2)
+        {
+            setWall(x, y, false);
+
+            // Along the top row and the left column only one way is left
+            bool up = y > 0 && (x == 0 || (m_rng() & 1));
+            if (up)
+                setWall(x, y - 1, false);
+            else if (x > 0)
+                setWall(x - 1, y, false);
+        }
+    }
+}
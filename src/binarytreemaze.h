@@ -0,0 +1,18 @@
+#ifndef BINARYTREEMAZE_H
+#define BINARYTREEMAZE_H
+
+#include "maze.h"
+
+// Links every room either up or left at random. The cheapest generator,
+// with a strong diagonal bias and open corridors along the top and left.
+class BinaryTreeMaze : public Maze
+{
+public:
+    BinaryTreeMaze(uint32_t width = 21,
+                   uint32_t height = 21);
+
+protected:
+    virtual void onGenerate() override;
+};
+
+#endif // BINARYTREEMAZE_H
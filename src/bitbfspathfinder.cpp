@@ -0,0 +1,291 @@
+#include "bitbfspathfinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BITBFS_HAS_AVX2_KERNEL 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static constexpr uint32_t s_unvisited = UINT32_MAX;
+
+static uint32_t countTrailingZeros(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// next[i] = (frontier shifted one cell in every direction) & open & !visited
+// frontier must be readable from -rowWords - 1 to count + rowWords
+using SweepKernel = void (*)(const uint64_t* frontier,
+                             const uint64_t* walls,
+                             const uint64_t* visited,
+                             uint64_t* next,
+                             size_t count,
+                             size_t rowWords);
+
+static void sweepScalar(const uint64_t* frontier,
+                        const uint64_t* walls,
+                        const uint64_t* visited,
+                        uint64_t* next,
+                        size_t count,
+                        size_t rowWords)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t east = (frontier[i] << 1) | (frontier[i - 1] >> 63);
+        uint64_t west = (frontier[i] >> 1) | (frontier[i + 1] << 63);
+        uint64_t vertical = frontier[i - rowWords] | frontier[i + rowWords];
+        next[i] = (east | west | vertical) & ~walls[i] & ~visited[i];
+    }
+}
+
+#ifdef BITBFS_HAS_AVX2_KERNEL
+__attribute__((target("avx2")))
+static void sweepAvx2(const uint64_t* frontier,
+                      const uint64_t* walls,
+                      const uint64_t* visited,
+                      uint64_t* next,
+                      size_t count,
+                      size_t rowWords)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i f = _mm256_loadu_si256((const __m256i*)(frontier + i));
+        __m256i left = _mm256_loadu_si256((const __m256i*)(frontier + i - 1));
+        __m256i right = _mm256_loadu_si256((const __m256i*)(frontier + i + 1));
+        __m256i up = _mm256_loadu_si256((const __m256i*)(frontier + i - rowWords));
+        __m256i down = _mm256_loadu_si256((const __m256i*)(frontier + i + rowWords));
+
+        __m256i east = _mm256_or_si256(_mm256_slli_epi64(f, 1),
+                                       _mm256_srli_epi64(left, 63));
+        __m256i west = _mm256_or_si256(_mm256_srli_epi64(f, 1),
+                                       _mm256_slli_epi64(right, 63));
+        __m256i reached = _mm256_or_si256(_mm256_or_si256(east, west),
+                                          _mm256_or_si256(up, down));
+        __m256i blocked = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(walls + i)),
+                                          _mm256_loadu_si256((const __m256i*)(visited + i)));
+        _mm256_storeu_si256((__m256i*)(next + i),
+                            _mm256_andnot_si256(blocked, reached));
+    }
+
+    sweepScalar(frontier + i, walls + i, visited + i, next + i, count - i, rowWords);
+}
+#endif
+
+static SweepKernel selectKernel()
+{
+#ifdef BITBFS_HAS_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2"))
+        return sweepAvx2;
+#endif
+    return sweepScalar;
+}
+
+static const SweepKernel s_sweep = selectKernel();
+
+BitBFSPathFinder::BitBFSPathFinder() {}
+
+const char* BitBFSPathFinder::getKernelName()
+{
+    return s_sweep == sweepScalar ? "scalar" : "avx2";
+}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+BitBFSPathFinder::findPath(Point start, Point end)
+{
+    beginSearch();
+
+    const auto& maze = getMaze();
+    if (!maze->isValidCell(start.x, start.y) || maze->isWall(start.x, start.y) ||
+        !maze->isValidCell(end.x, end.y) || maze->isWall(end.x, end.y))
+    {
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+
+    m_walls = maze->getWords();
+    m_rowWords = maze->getRowWords();
+    m_rowBits = m_rowWords * 64;
+    m_wordCount = (size_t)m_rowWords * maze->getHeight();
+
+    m_visited.assign(m_wordCount, 0);
+    m_frontierBits.assign(m_wordCount + 2 * (m_rowWords + 1), 0);
+    m_nextBits.assign(m_wordCount, 0);
+    m_dist.assign(m_wordCount * 64, s_unvisited);
+    m_frontier.clear();
+    m_next.clear();
+
+    uint32_t startCell = start.y * m_rowBits + start.x;
+    uint32_t endCell = end.y * m_rowBits + end.x;
+
+    std::vector<IterationData> iterData;
+
+    visit(startCell, 0);
+    m_frontier.swap(m_next);
+
+    for (uint32_t level = 1;
+         !m_frontier.empty() && m_dist[endCell] == s_unvisited;
+         level++)
+    {
+        if (shouldStop(m_frontier.size()))
+            break;
+
+        uint32_t rowLo = UINT32_MAX, rowHi = 0;
+        for (uint32_t cell : m_frontier)
+        {
+            rowLo = std::min(rowLo, cell / m_rowBits);
+            rowHi = std::max(rowHi, cell / m_rowBits);
+        }
+
+        // The sweep pays for every word in the rows the frontier spans
+        size_t sweepWords = (size_t)(rowHi - rowLo + 3) * m_rowWords;
+        if (m_frontier.size() * 2 >= sweepWords)
+            expandDense(level, rowLo, rowHi);
+        else
+            expandSparse(level);
+
+        // One iteration per level, showing the wave of newly reached cells
+        if (isTraceEnabled())
+        {
+            IterationData it;
+            it.currentPoint = Point{(int)(m_frontier[0] % m_rowBits),
+                                    (int)(m_frontier[0] / m_rowBits)};
+            for (uint32_t cell : m_next)
+            {
+                it.neighbors[Point{(int)(cell % m_rowBits),
+                                   (int)(cell / m_rowBits)}] = level;
+            }
+            iterData.push_back(std::move(it));
+        }
+
+        m_frontier.swap(m_next);
+        m_next.clear();
+    }
+
+    uint32_t target = endCell;
+    if (m_dist[endCell] != s_unvisited)
+    {
+        setLastStatus(SearchStatus::Found);
+    }
+    else if (getLastStatus() == SearchStatus::NoPath)
+    {
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+    else
+    {
+        // Stopped early, head for the frontier cell closest to the end
+        uint32_t best = UINT32_MAX;
+        for (uint32_t cell : m_frontier)
+        {
+            uint32_t d = std::abs((int)(cell % m_rowBits) - end.x) +
+                         std::abs((int)(cell / m_rowBits) - end.y);
+            if (d < best)
+            {
+                best = d;
+                target = cell;
+            }
+        }
+    }
+
+    // Walk back down the distance field from the target
+    std::vector<Point> path(m_dist[target] + 1);
+    uint32_t cell = target;
+    for (uint32_t d = m_dist[target]; ; d--)
+    {
+        path[d] = Point{(int)(cell % m_rowBits), (int)(cell / m_rowBits)};
+        if (d == 0)
+            break;
+
+        uint32_t candidates[4] = { cell + 1, cell - 1, cell + m_rowBits, cell - m_rowBits };
+        for (uint32_t n : candidates)
+        {
+            if (n < m_dist.size() && m_dist[n] == d - 1)
+            {
+                cell = n;
+                break;
+            }
+        }
+    }
+
+    return std::make_pair(std::move(path), std::move(iterData));
+}
+
+void BitBFSPathFinder::expandSparse(uint32_t level)
+{
+    size_t cellCount = m_wordCount * 64;
+
+    for (uint32_t cell : m_frontier)
+    {
+        // Horizontal steps off a row land on its padding wall bits
+        uint32_t candidates[4] = { cell + 1, cell - 1, cell + m_rowBits, cell - m_rowBits };
+        for (uint32_t n : candidates)
+        {
+            if (n >= cellCount)
+                continue;
+
+            uint64_t bit = 1ull << (n & 63);
+            if ((m_walls[n >> 6] | m_visited[n >> 6]) & bit)
+                continue;
+
+            visit(n, level);
+        }
+    }
+}
+
+void BitBFSPathFinder::expandDense(uint32_t level, uint32_t rowLo, uint32_t rowHi)
+{
+    uint64_t* frontier = m_frontierBits.data() + m_rowWords + 1;
+    for (uint32_t cell : m_frontier)
+    {
+        frontier[cell >> 6] |= 1ull << (cell & 63);
+    }
+
+    size_t height = m_wordCount / m_rowWords;
+    size_t lo = (size_t)(rowLo > 0 ? rowLo - 1 : 0) * m_rowWords;
+    size_t hi = std::min<size_t>(rowHi + 2, height) * m_rowWords;
+
+    s_sweep(frontier + lo,
+            m_walls + lo,
+            m_visited.data() + lo,
+            m_nextBits.data() + lo,
+            hi - lo,
+            m_rowWords);
+
+    for (size_t i = lo; i < hi; i++)
+    {
+        uint64_t bits = m_nextBits[i];
+        m_nextBits[i] = 0;
+
+        while (bits)
+        {
+            uint32_t bit = countTrailingZeros(bits);
+            bits &= bits - 1;
+            visit(i * 64 + bit, level);
+        }
+    }
+
+    for (uint32_t cell : m_frontier)
+    {
+        frontier[cell >> 6] = 0;
+    }
+}
+
+void BitBFSPathFinder::visit(uint32_t cell, uint32_t level)
+{
+    m_visited[cell >> 6] |= 1ull << (cell & 63);
+    m_dist[cell] = level;
+    m_next.push_back(cell);
+}
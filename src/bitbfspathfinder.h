@@ -0,0 +1,42 @@
+#ifndef BITBFSPATHFINDER_H
+#define BITBFSPATHFINDER_H
+
+#include "pathfinder.h"
+
+// Level-synchronous BFS over the maze's wall bits.
+// Each level is expanded either cell by cell when the frontier is small, or
+// as one sweep of shifts and masks over the bitset rows it spans when it is
+// large. The sweep uses AVX2 when the CPU has it and plain 64-bit words
+// otherwise, picked once at runtime.
+class BitBFSPathFinder : public PathFinder
+{
+public:
+    BitBFSPathFinder();
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    // Name of the sweep kernel in use, "avx2" or "scalar"
+    static const char* getKernelName();
+
+private:
+    void expandSparse(uint32_t level);
+    void expandDense(uint32_t level, uint32_t rowLo, uint32_t rowHi);
+    void visit(uint32_t cell, uint32_t level);
+
+private:
+    const uint64_t* m_walls = nullptr;
+    uint32_t m_rowWords = 0;
+    uint32_t m_rowBits = 0;
+    size_t m_wordCount = 0;
+
+    std::vector<uint64_t> m_visited;
+    std::vector<uint64_t> m_frontierBits; // Guarded by a row of zero words on each side
+    std::vector<uint64_t> m_nextBits;
+    std::vector<uint32_t> m_frontier;
+    std::vector<uint32_t> m_next;
+    std::vector<uint32_t> m_dist;
+};
+
+#endif // BITBFSPATHFINDER_H
@@ -0,0 +1,90 @@
+#include "bucketqueue.h"
+
+#include <algorithm>
+
+BucketQueue::BucketQueue(std::pmr::memory_resource* resource)
+    : m_buckets(resource)
+{}
+
+void BucketQueue::clear()
+{
+    // Only the buckets that were used can hold items, their capacity stays
+    if (!m_buckets.empty())
+    {
+        uint32_t mask = m_buckets.size() - 1;
+        uint32_t span = std::min<uint32_t>(m_highest - m_lowest, mask);
+        for (uint32_t i = 0; i <= span; i++)
+        {
+            m_buckets[(m_lowest + i) & mask].clear();
+        }
+    }
+
+    m_lowest = 0;
+    m_highest = 0;
+    m_size = 0;
+}
+
+bool BucketQueue::empty() const
+{
+    return m_size == 0;
+}
+
+size_t BucketQueue::size() const
+{
+    return m_size;
+}
+
+void BucketQueue::push(uint32_t key, uint32_t item)
+{
+    uint32_t lowest = m_size == 0 ? key : std::min(m_lowest, key);
+    uint32_t highest = m_size == 0 ? key : std::max(m_highest, key);
+
+    if (highest - lowest >= m_buckets.size())
+        grow(highest - lowest);
+
+    m_lowest = lowest;
+    m_highest = highest;
+    m_buckets[key & (m_buckets.size() - 1)].push_back(item);
+    m_size++;
+}
+
+std::pair<uint32_t, uint32_t> BucketQueue::pop()
+{
+    uint32_t mask = m_buckets.size() - 1;
+    while (m_buckets[m_lowest & mask].empty())
+    {
+        m_lowest++;
+    }
+
+    auto& bucket = m_buckets[m_lowest & mask];
+    uint32_t item = bucket.back();
+    bucket.pop_back();
+    m_size--;
+
+    return {m_lowest, item};
+}
+
+void BucketQueue::grow(uint32_t span)
+{
+    size_t count = std::max<size_t>(m_buckets.size(), s_minBuckets);
+    while (count <= span)
+    {
+        count *= 2;
+    }
+
+    // Every queued key moves to its slot in the larger ring. The keys of
+    // the old ring spanned fewer buckets than it had, so no two share one.
+    std::pmr::vector<std::pmr::vector<uint32_t>> ring(count, m_buckets.get_allocator());
+    if (m_size > 0)
+    {
+        uint32_t mask = m_buckets.size() - 1;
+        for (uint32_t i = 0; i <= m_highest - m_lowest; i++)
+        {
+            auto& bucket = m_buckets[(m_lowest + i) & mask];
+            if (!bucket.empty())
+                ring[(m_lowest + i) & (count - 1)] = std::move(bucket);
+        }
+    }
+
+    m_buckets = std::move(ring);
+}
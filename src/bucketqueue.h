@@ -0,0 +1,46 @@
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// Monotone priority queue for non-negative integer keys.
+// Items are kept in one bucket per key and popped from the lowest non-empty
+// bucket, so push and pop are O(1) as long as no key smaller than the last
+// popped one is pushed. That holds for Dijkstra with non-negative costs and
+// for A* with a consistent heuristic, where f never decreases.
+// The buckets form a ring indexed by key modulo its size (Dial's
+// algorithm), so memory follows the spread of the keys queued at once,
+// at most the largest step cost plus one, and not the keys themselves. The
+// ring doubles whenever a key would not fit.
+class BucketQueue
+{
+public:
+    // The buckets are taken from resource, the heap unless told otherwise
+    explicit BucketQueue(std::pmr::memory_resource* resource =
+                             std::pmr::get_default_resource());
+
+    void clear();
+    bool empty() const;
+    size_t size() const;
+
+    void push(uint32_t key, uint32_t item);
+    // Lowest key first, the most recently pushed item among equal keys
+    std::pair<uint32_t, uint32_t> pop();
+
+private:
+    void grow(uint32_t span);
+
+private:
+    static constexpr uint32_t s_minBuckets = 16;
+
+    std::pmr::vector<std::pmr::vector<uint32_t>> m_buckets; // Power of two, kept between uses
+    uint32_t m_lowest = 0;  // Keys in the ring are m_lowest..m_highest
+    uint32_t m_highest = 0;
+    size_t m_size = 0;
+};
+
+#endif // BUCKETQUEUE_H
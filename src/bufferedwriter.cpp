@@ -0,0 +1,78 @@
+#include "bufferedwriter.h"
+
+#include <cstring>
+
+BufferedWriter::BufferedWriter(FILE* file, size_t capacity)
+    : m_file(file),
+      m_buffer(capacity)
+{}
+
+BufferedWriter::BufferedWriter(const std::string& path, size_t capacity)
+    : m_file(fopen(path.c_str(), "wb")),
+      m_ownsFile(true),
+      m_buffer(capacity)
+{}
+
+BufferedWriter::~BufferedWriter()
+{
+    flush();
+
+    if (m_ownsFile && m_file)
+        fclose(m_file);
+}
+
+bool BufferedWriter::isOpen() const
+{
+    return m_file != nullptr;
+}
+
+bool BufferedWriter::good() const
+{
+    return m_file != nullptr && !m_failed;
+}
+
+void BufferedWriter::write(const void* data, size_t size)
+{
+    if (m_size + size > m_buffer.size())
+    {
+        flush();
+
+        // Larger than the whole buffer, no point in copying it first
+        if (size > m_buffer.size())
+        {
+            if (m_file && fwrite(data, 1, size, m_file) != size)
+                m_failed = true;
+            return;
+        }
+    }
+
+    std::memcpy(m_buffer.data() + m_size, data, size);
+    m_size += size;
+}
+
+void BufferedWriter::write(const char* str)
+{
+    write(str, std::strlen(str));
+}
+
+void BufferedWriter::put(char c)
+{
+    if (m_size == m_buffer.size())
+        flush();
+
+    m_buffer[m_size++] = c;
+}
+
+void BufferedWriter::flush()
+{
+    if (m_size == 0)
+        return;
+
+    if (m_file && fwrite(m_buffer.data(), 1, m_size, m_file) != m_size)
+        m_failed = true;
+
+    m_size = 0;
+
+    if (m_file)
+        fflush(m_file);
+}
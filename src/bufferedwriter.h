@@ -0,0 +1,40 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Collects small writes into one large buffer before handing them to stdio
+class BufferedWriter
+{
+public:
+    static constexpr size_t defaultCapacity = 1 << 20;
+
+public:
+    explicit BufferedWriter(FILE* file,
+                            size_t capacity = defaultCapacity);
+    explicit BufferedWriter(const std::string& path,
+                            size_t capacity = defaultCapacity);
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+    ~BufferedWriter();
+
+    bool isOpen() const;
+    bool good() const;
+
+    void write(const void* data, size_t size);
+    void write(const char* str);
+    void put(char c);
+    void flush();
+
+private:
+    FILE* m_file = nullptr;
+    bool m_ownsFile = false;
+    bool m_failed = false;
+    std::vector<char> m_buffer;
+    size_t m_size = 0;
+};
+
+#endif // BUFFEREDWRITER_H
@@ -0,0 +1,74 @@
+#include "cachedpathfinder.h"
+
+#include <typeinfo>
+
+CachedPathFinder::CachedPathFinder(const std::shared_ptr<PathFinder>& finder,
+                                   const std::shared_ptr<PathCache>& cache)
+    : m_finder(finder),
+      m_cache(cache)
+{}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+CachedPathFinder::findPath(Point start, Point end)
+{
+    beginSearch();
+
+    const auto& maze = getMaze();
+    m_finder->setMaze(maze);
+    m_finder->setSearchLimits(getSearchLimits());
+    m_finder->setTraceEnabled(isTraceEnabled());
+
+    if (maze.get() != m_cachedMaze ||
+        maze->getRevision() != m_cachedRevision)
+    {
+        m_cache->clear();
+        m_cachedMaze = maze.get();
+        m_cachedRevision = maze->getRevision();
+    }
+
+    const PathFinder& finder = *m_finder;
+    PathCacheKey key{maze->getHash(),
+                     typeid(finder).hash_code(),
+                     finder.getVariant(),
+                     finder.isTraceEnabled(),
+                     start,
+                     end};
+
+    if (auto cached = m_cache->find(key))
+    {
+        setLastStatus(cached->first.empty() ? SearchStatus::NoPath
+                                            : SearchStatus::Found);
+        return *cached;
+    }
+
+    auto result = m_finder->findPath(start, end);
+    setLastStatus(m_finder->getLastStatus());
+
+    // Partial results of a stopped search are not answers worth keeping
+    if (getLastStatus() == SearchStatus::Found ||
+        getLastStatus() == SearchStatus::NoPath)
+    {
+        m_cache->insert(key, result);
+    }
+    return result;
+}
+
+bool CachedPathFinder::supportsTopology(Maze::Topology topology) const
+{
+    return m_finder->supportsTopology(topology);
+}
+
+uint64_t CachedPathFinder::getVariant() const
+{
+    return m_finder->getVariant();
+}
+
+const std::shared_ptr<PathFinder>& CachedPathFinder::getFinder() const
+{
+    return m_finder;
+}
+
+const std::shared_ptr<PathCache>& CachedPathFinder::getCache() const
+{
+    return m_cache;
+}
@@ -0,0 +1,36 @@
+#ifndef CACHEDPATHFINDER_H
+#define CACHEDPATHFINDER_H
+
+#include "pathfinder.h"
+#include "pathcache.h"
+
+// Serves repeated queries from a PathCache and forwards misses to the
+// wrapped solver. The maze, the limits and the trace flag are passed on to
+// it with every query. The cache is dropped whenever the maze is
+// regenerated, cleared or resized.
+class CachedPathFinder : public PathFinder
+{
+public:
+    CachedPathFinder(const std::shared_ptr<PathFinder>& finder,
+                     const std::shared_ptr<PathCache>& cache =
+                         std::make_shared<PathCache>());
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    virtual bool supportsTopology(Maze::Topology topology) const override;
+    virtual uint64_t getVariant() const override;
+
+    const std::shared_ptr<PathFinder>& getFinder() const;
+    const std::shared_ptr<PathCache>& getCache() const;
+
+private:
+    std::shared_ptr<PathFinder> m_finder;
+    std::shared_ptr<PathCache> m_cache;
+
+    const Maze* m_cachedMaze = nullptr;
+    uint64_t m_cachedRevision = 0;
+};
+
+#endif // CACHEDPATHFINDER_H
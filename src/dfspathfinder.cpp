@@ -1,83 +1,29 @@
 #include "dfspathfinder.h"
 
-#include <stack>
-#include <algorithm>
-
 DFSPathFinder::DFSPathFinder() {}
 
 std::pair<std::vector<Point>, std::vector<IterationData>>
-DFSPathFinder::findPath(Point start,
-                        Point end)
+DFSPathFinder::findPath(Point start, Point end)
 {
-    std::stack<Point> stack;
-    std::unordered_map<Point, Point, PointHash> cameFrom;
-    std::vector<IterationData> iterData;
-
-    // Start DFS from the start point
-    stack.push(start);
-    cameFrom[start] = start; // Mark start as its own parent
-
-    while (!stack.empty())
-    {
-        IterationData it;
-        Point current = stack.top();
-        stack.pop();
-        it.currentPoint = current;
-
-        // If we reached the end point, reconstruct and return the path
-        if (current == end)
-        {
-            return std::make_pair(reconstructPath(cameFrom, current, start),
-                                  iterData);
-        }
-
-        // Get all valid neighbors
-        for (const Point& neighbor : getNeighbors(current))
-        {
-            // If we haven't visited this neighbor yet
-            if (!isVisited(cameFrom, neighbor))
-            {
-                stack.push(neighbor);
-                cameFrom[neighbor] = current;
-                it.neighbors[neighbor] = 1; // In DFS, all edges have the same weight
-            }
-        }
-
-        // Record the current state of the path for visualization
-        it.path = reconstructPath(cameFrom, current, start);
-        iterData.push_back(it);
-    }
-
-    // If no path is found, return empty vectors
-    return std::make_pair(std::vector<Point>(),
-                          std::vector<IterationData>());
+    return findCorePath<SolverCore::Uninformed<true>>(start, end);
 }
 
-bool DFSPathFinder::isVisited(const std::unordered_map<Point, Point,PointHash> &visited,
-                              const Point &point) const
+bool DFSPathFinder::supportsTopology(Maze::Topology) const
 {
-    return visited.find(point) != visited.end();
+    return true;
 }
 
-std::vector<Point> DFSPathFinder::reconstructPath(const std::unordered_map<Point, Point, PointHash> &cameFrom, Point current, Point start) const
+bool DFSPathFinder::isResumable() const
 {
-    std::vector<Point> path;
-    path.push_back(current);
-
-    // Reconstruct path until we reach the start point
-    while (current != start && cameFrom.find(current) != cameFrom.end())
-    {
-        current = cameFrom.at(current);
-        path.push_back(current);
-    }
+    return true;
+}
 
-    // Only include the path if we successfully reached the start point
-    if (current == start)
-    {
-        std::reverse(path.begin(), path.end());
-        return path;
-    }
+bool DFSPathFinder::onBegin(Point start, Point end)
+{
+    return beginCoreSteps(m_search, start, end);
+}
 
-    // If we couldn't reach the start point, return an empty path
-    return std::vector<Point>();
+void DFSPathFinder::onStep(uint64_t maxExpansions)
+{
+    stepCore(m_search, maxExpansions);
 }
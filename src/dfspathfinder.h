@@ -2,6 +2,7 @@
 #define DFSPATHFINDER_H
 
 #include "pathfinder.h"
+#include "solvercore.h"
 
 class DFSPathFinder : public PathFinder
 {
@@ -12,13 +13,18 @@ public:
     std::pair<std::vector<Point>, std::vector<IterationData>>
     findPath(Point start, Point end) override;
 
-private:
-    bool isVisited(const std::unordered_map<Point, Point, PointHash>& visited,
-                   const Point& point) const;
+    virtual bool supportsTopology(Maze::Topology topology) const override;
+
+    virtual bool isResumable() const override;
 
-    std::vector<Point> reconstructPath(const std::unordered_map<Point, Point, PointHash>& cameFrom,
-                                       Point current,
-                                       Point start) const;
+protected:
+    virtual bool onBegin(Point start, Point end) override;
+    virtual void onStep(uint64_t maxExpansions) override;
+
+private:
+    // The stepped search, kept between searches to reuse its capacity.
+    // findPath() draws its own from the ScratchArena.
+    SolverCore::Uninformed<true> m_search;
 };
 
 #endif // DFSPATHFINDER_H
@@ -0,0 +1,29 @@
+#include "dijkstrapathfinder.h"
+
+DijkstraPathFinder::DijkstraPathFinder() {}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+DijkstraPathFinder::findPath(Point start, Point end)
+{
+    return findCorePath<Search>(start, end);
+}
+
+bool DijkstraPathFinder::supportsTopology(Maze::Topology) const
+{
+    return true;
+}
+
+bool DijkstraPathFinder::isResumable() const
+{
+    return true;
+}
+
+bool DijkstraPathFinder::onBegin(Point start, Point end)
+{
+    return beginCoreSteps(m_search, start, end);
+}
+
+void DijkstraPathFinder::onStep(uint64_t maxExpansions)
+{
+    stepCore(m_search, maxExpansions);
+}
@@ -0,0 +1,35 @@
+#ifndef DIJKSTRAPATHFINDER_H
+#define DIJKSTRAPATHFINDER_H
+
+#include "pathfinder.h"
+#include "bucketqueue.h"
+#include "solvercore.h"
+
+// Cheapest path by the maze's cell costs. Costs are small integers, so the
+// open set is a bucket queue (Dial's algorithm).
+class DijkstraPathFinder : public PathFinder
+{
+public:
+    DijkstraPathFinder();
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    virtual bool supportsTopology(Maze::Topology topology) const override;
+
+    virtual bool isResumable() const override;
+
+protected:
+    virtual bool onBegin(Point start, Point end) override;
+    virtual void onStep(uint64_t maxExpansions) override;
+
+private:
+    using Search = SolverCore::BestFirst<BucketQueue, false>;
+
+    // The stepped search, kept between searches to reuse its capacity.
+    // findPath() draws its own from the ScratchArena.
+    Search m_search;
+};
+
+#endif // DIJKSTRAPATHFINDER_H
@@ -0,0 +1,353 @@
+#include "distancefield.h"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static uint32_t countTrailingZeros(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+DistanceField::DistanceField(unsigned threadCount)
+    : m_pool(threadCount)
+    , m_next(m_pool.size())
+{
+}
+
+void DistanceField::compute(const Maze& maze, Point source)
+{
+    compute(maze, std::vector<Point>{ source });
+}
+
+void DistanceField::compute(const Maze& maze, const std::vector<Point>& sources)
+{
+    reset(maze);
+
+    for (const Point& source : sources)
+    {
+        if (!maze.isValidCell(source.x, source.y) || maze.isWall(source.x, source.y))
+            continue;
+
+        uint32_t cell = source.y * m_rowBits + source.x;
+        uint64_t bit = 1ull << (cell & 63);
+        uint64_t visited = m_visited[cell >> 6].load(std::memory_order_relaxed);
+        if (visited & bit)
+            continue;
+
+        m_visited[cell >> 6].store(visited | bit, std::memory_order_relaxed);
+        m_dist[cell] = 0;
+        m_next[0].push_back(cell);
+    }
+    gatherNext(0);
+
+    for (uint32_t level = 1;
+         !m_frontier.empty() &&
+         (m_targetCell == UINT32_MAX || m_dist[m_targetCell] == unreachable);
+         level++)
+    {
+        if (m_stop && m_stop(m_frontier.size()))
+        {
+            m_stopped = true;
+            break;
+        }
+
+        auto levelStart = std::chrono::steady_clock::now();
+        LevelStats stats;
+
+        // Bottom-up pays for every word in the rows the frontier spans,
+        // top-down for every frontier cell
+        size_t sweepWords = (size_t)(m_frontierRowHi - m_frontierRowLo + 3) * m_rowWords;
+        if (m_frontier.size() * 2 >= sweepWords)
+        {
+            expandBottomUp(level, m_frontierRowLo, m_frontierRowHi);
+            stats.bottomUp = true;
+        }
+        else
+        {
+            if (m_frontierBitsValid)
+            {
+                uint64_t* frontier = m_frontierBits.data() + m_rowWords + 1;
+                std::fill(frontier + (size_t)m_frontierRowLo * m_rowWords,
+                          frontier + (size_t)(m_frontierRowHi + 1) * m_rowWords,
+                          0);
+                m_frontierBitsValid = false;
+            }
+            expandTopDown(level);
+        }
+
+        gatherNext(level);
+
+        stats.frontier = m_frontier.size();
+        stats.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - levelStart).count();
+        m_levelStats.push_back(stats);
+    }
+
+    // Leave the bitset clean for the next run
+    if (m_frontierBitsValid)
+    {
+        std::fill(m_frontierBits.begin(), m_frontierBits.end(), 0);
+        m_frontierBitsValid = false;
+    }
+}
+
+void DistanceField::setTarget(Point target)
+{
+    m_target = target;
+}
+
+void DistanceField::clearTarget()
+{
+    m_target = { -1, -1 };
+}
+
+void DistanceField::setStopCondition(std::function<bool(size_t frontier)> stop)
+{
+    m_stop = std::move(stop);
+}
+
+bool DistanceField::wasStopped() const
+{
+    return m_stopped;
+}
+
+uint32_t DistanceField::at(int cx, int cy) const
+{
+    if (cx < 0 || cy < 0 || (uint32_t)cx >= m_width || (uint32_t)cy >= m_height)
+        return unreachable;
+
+    return m_dist[(size_t)cy * m_rowBits + cx];
+}
+
+const std::vector<uint32_t>& DistanceField::getDistances() const
+{
+    return m_dist;
+}
+
+uint32_t DistanceField::getStride() const
+{
+    return m_rowBits;
+}
+
+uint32_t DistanceField::getWidth() const
+{
+    return m_width;
+}
+
+uint32_t DistanceField::getHeight() const
+{
+    return m_height;
+}
+
+uint32_t DistanceField::getMaxDistance() const
+{
+    return m_maxDistance;
+}
+
+size_t DistanceField::getReachedCount() const
+{
+    return m_reached;
+}
+
+unsigned DistanceField::getThreadCount() const
+{
+    return m_pool.size();
+}
+
+const std::vector<DistanceField::LevelStats>& DistanceField::getLevelStats() const
+{
+    return m_levelStats;
+}
+
+void DistanceField::reset(const Maze& maze)
+{
+    m_walls = maze.getWords();
+    m_width = maze.getWidth();
+    m_height = maze.getHeight();
+    m_rowWords = maze.getRowWords();
+    m_rowBits = m_rowWords * 64;
+    m_wordCount = (size_t)m_rowWords * m_height;
+    m_maxDistance = 0;
+    m_reached = 0;
+    m_levelStats.clear();
+    m_stopped = false;
+
+    m_targetCell = UINT32_MAX;
+    if (maze.isValidCell(m_target.x, m_target.y))
+        m_targetCell = m_target.y * m_rowBits + m_target.x;
+
+    if (m_visitedSize != m_wordCount)
+    {
+        m_visited.reset(new std::atomic<uint64_t>[m_wordCount]);
+        m_visitedSize = m_wordCount;
+    }
+    m_frontierBits.assign(m_wordCount + 2 * (m_rowWords + 1), 0);
+    m_nextBits.assign(m_frontierBits.size(), 0);
+    m_frontierBitsValid = false;
+    m_frontier.clear();
+    for (auto& next : m_next)
+    {
+        next.clear();
+    }
+
+    // Large fields are cleared in parallel, which also spreads their pages
+    // over the threads that will touch them
+    m_dist.resize(m_wordCount * 64);
+    auto clearRange = [this](unsigned index, unsigned count)
+    {
+        size_t begin = m_wordCount * index / count;
+        size_t end = m_wordCount * (index + 1) / count;
+        for (size_t i = begin; i < end; i++)
+        {
+            m_visited[i].store(0, std::memory_order_relaxed);
+        }
+        std::fill(m_dist.begin() + begin * 64, m_dist.begin() + end * 64, unreachable);
+    };
+
+    if (m_wordCount * 64 >= s_parallelCells)
+        m_pool.run(clearRange);
+    else
+        clearRange(0, 1);
+}
+
+void DistanceField::expandTopDown(uint32_t level)
+{
+    size_t cellCount = m_wordCount * 64;
+
+    auto expand = [&](unsigned index, unsigned count)
+    {
+        size_t begin = m_frontier.size() * index / count;
+        size_t end = m_frontier.size() * (index + 1) / count;
+        auto& next = m_next[index];
+
+        for (size_t i = begin; i < end; i++)
+        {
+            uint32_t cell = m_frontier[i];
+
+            // Horizontal steps off a row land on its padding wall bits
+            uint32_t candidates[4] = { cell + 1, cell - 1, cell + m_rowBits, cell - m_rowBits };
+            for (uint32_t n : candidates)
+            {
+                if (n >= cellCount)
+                    continue;
+
+                uint64_t bit = 1ull << (n & 63);
+                if (m_walls[n >> 6] & bit)
+                    continue;
+
+                auto& word = m_visited[n >> 6];
+                uint64_t visited = word.load(std::memory_order_relaxed);
+                if (visited & bit)
+                    continue;
+
+                // With several threads only the one that sets the bit owns the cell
+                if (count == 1)
+                    word.store(visited | bit, std::memory_order_relaxed);
+                else if (word.fetch_or(bit, std::memory_order_relaxed) & bit)
+                    continue;
+
+                m_dist[n] = level;
+                next.push_back(n);
+            }
+        }
+    };
+
+    if (m_frontier.size() >= s_parallelCells)
+        m_pool.run(expand);
+    else
+        expand(0, 1);
+}
+
+void DistanceField::expandBottomUp(uint32_t level, uint32_t rowLo, uint32_t rowHi)
+{
+    uint64_t* frontier = m_frontierBits.data() + m_rowWords + 1;
+    uint64_t* nextBits = m_nextBits.data() + m_rowWords + 1;
+
+    if (!m_frontierBitsValid)
+    {
+        for (uint32_t cell : m_frontier)
+        {
+            frontier[cell >> 6] |= 1ull << (cell & 63);
+        }
+    }
+
+    size_t lo = (size_t)(rowLo > 0 ? rowLo - 1 : 0) * m_rowWords;
+    size_t hi = std::min<size_t>(rowHi + 2, m_height) * m_rowWords;
+
+    // Every thread owns a run of words, so visited and next need no atomics here
+    auto sweep = [&](unsigned index, unsigned count)
+    {
+        size_t begin = lo + (hi - lo) * index / count;
+        size_t end = lo + (hi - lo) * (index + 1) / count;
+        auto& next = m_next[index];
+
+        for (size_t i = begin; i < end; i++)
+        {
+            uint64_t east = (frontier[i] << 1) | (frontier[i - 1] >> 63);
+            uint64_t west = (frontier[i] >> 1) | (frontier[i + 1] << 63);
+            uint64_t vertical = frontier[i - m_rowWords] | frontier[i + m_rowWords];
+
+            uint64_t visited = m_visited[i].load(std::memory_order_relaxed);
+            uint64_t bits = (east | west | vertical) & ~m_walls[i] & ~visited;
+            if (!bits)
+                continue;
+
+            m_visited[i].store(visited | bits, std::memory_order_relaxed);
+            nextBits[i] = bits;
+
+            while (bits)
+            {
+                uint32_t cell = i * 64 + countTrailingZeros(bits);
+                bits &= bits - 1;
+                m_dist[cell] = level;
+                next.push_back(cell);
+            }
+        }
+    };
+
+    if (m_frontier.size() >= s_parallelCells)
+        m_pool.run(sweep);
+    else
+        sweep(0, 1);
+
+    // The current frontier lies inside the swept rows; clear it and hand the
+    // next level's bits over as the new frontier
+    std::fill(frontier + lo, frontier + hi, 0);
+    m_frontierBits.swap(m_nextBits);
+    m_frontierBitsValid = true;
+}
+
+void DistanceField::gatherNext(uint32_t level)
+{
+    m_frontier.clear();
+    uint32_t minCell = UINT32_MAX, maxCell = 0;
+
+    for (auto& next : m_next)
+    {
+        for (uint32_t cell : next)
+        {
+            minCell = std::min(minCell, cell);
+            maxCell = std::max(maxCell, cell);
+        }
+        m_frontier.insert(m_frontier.end(), next.begin(), next.end());
+        next.clear();
+    }
+
+    if (m_frontier.empty())
+        return;
+
+    m_maxDistance = level;
+    m_reached += m_frontier.size();
+    m_frontierRowLo = minCell / m_rowBits;
+    m_frontierRowHi = maxCell / m_rowBits;
+}
@@ -0,0 +1,98 @@
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include "threadpool.h"
+#include "pathfinder.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+// Step distances from one or more sources to every open cell, from a single
+// breadth-first sweep.
+// The search is level synchronous and switches direction per level: small
+// frontiers push out from their cells (top-down), large ones are found by
+// checking every unvisited word of the rows they span against the frontier
+// bitset (bottom-up). Large levels are split across a thread pool.
+class DistanceField
+{
+public:
+    static constexpr uint32_t unreachable = UINT32_MAX;
+
+    struct LevelStats
+    {
+        uint32_t frontier = 0; // Cells reached at this level
+        bool bottomUp = false;
+        double milliseconds = 0.0;
+    };
+
+public:
+    // Zero threads picks one per hardware thread
+    explicit DistanceField(unsigned threadCount = 0);
+
+    void compute(const Maze& maze, Point source);
+    // Every source starts at distance 0, walls and out of range points are skipped
+    void compute(const Maze& maze, const std::vector<Point>& sources);
+
+    // Stops the sweep once the target is reached, leaving farther cells
+    // unreachable. Out of range points disable the early exit.
+    void setTarget(Point target);
+    void clearTarget();
+
+    // Asked before every level with the size of its frontier; returning
+    // true ends the sweep there and leaves the rest of the field unreachable
+    void setStopCondition(std::function<bool(size_t frontier)> stop);
+    bool wasStopped() const;
+
+    uint32_t at(int cx, int cy) const;
+    // Row-major distances, cell (x, y) at y * getStride() + x
+    const std::vector<uint32_t>& getDistances() const;
+    uint32_t getStride() const;
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    // Largest finite distance in the field
+    uint32_t getMaxDistance() const;
+    size_t getReachedCount() const;
+    unsigned getThreadCount() const;
+    // Timing of every level of the last compute, level 1 first
+    const std::vector<LevelStats>& getLevelStats() const;
+
+private:
+    void reset(const Maze& maze);
+    void expandTopDown(uint32_t level);
+    void expandBottomUp(uint32_t level, uint32_t rowLo, uint32_t rowHi);
+    void gatherNext(uint32_t level);
+
+private:
+    // Levels with fewer cells than this stay on the calling thread
+    static constexpr size_t s_parallelCells = 4096;
+
+    ThreadPool m_pool;
+
+    const uint64_t* m_walls = nullptr;
+    uint32_t m_width = 0, m_height = 0;
+    uint32_t m_rowWords = 0;
+    uint32_t m_rowBits = 0;
+    size_t m_wordCount = 0;
+    uint32_t m_maxDistance = 0;
+    size_t m_reached = 0;
+    Point m_target = { -1, -1 };
+    uint32_t m_targetCell = UINT32_MAX;
+    std::vector<LevelStats> m_levelStats;
+    std::function<bool(size_t)> m_stop;
+    bool m_stopped = false;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> m_visited;
+    size_t m_visitedSize = 0;
+    std::vector<uint64_t> m_frontierBits; // Guarded by a row of zero words on each side
+    std::vector<uint64_t> m_nextBits;     // Same layout, filled by bottom-up levels
+    bool m_frontierBitsValid = false;
+    std::vector<uint32_t> m_frontier;
+    uint32_t m_frontierRowLo = 0, m_frontierRowHi = 0;
+    std::vector<std::vector<uint32_t>> m_next; // One per thread
+    std::vector<uint32_t> m_dist;
+};
+
+#endif // DISTANCEFIELD_H
@@ -0,0 +1,187 @@
+#include "ellermaze.h"
+#include "mazefile.h"
+
+#include <iostream>
+
+static uint32_t roundUpOdd(uint32_t size)
+{
+    return size % 2 == 0 ? size + 1 : size;
+}
+
+static uint32_t findSet(std::vector<uint32_t>& parent, uint32_t c)
+{
+    while (parent[c] != c)
+    {
+        parent[c] = parent[parent[c]];
+        c = parent[c];
+    }
+    return c;
+}
+
+static void openCell(std::vector<uint64_t>& row, uint32_t x)
+{
+    row[x >> 6] &= ~(1ull << (x & 63));
+}
+
+// Rooms sit on even coordinates. Every room row is followed by a row of the
+// passages down from it, except the last.
+static void carveRows(uint32_t width,
+                      uint32_t height,
+                      std::mt19937& rng,
+                      const EllerMaze::RowSink& sink)
+{
+    const uint32_t none = UINT32_MAX;
+    uint32_t cols = (width + 1) / 2;
+    uint32_t rows = (height + 1) / 2;
+    uint32_t rowWords = width / 64 + 1;
+
+    // Sets are a union-find over the columns of the current row. A set
+    // carried down from the row above is named by one of its columns.
+    std::vector<uint32_t> label(cols, none);
+    std::vector<uint32_t> parent(cols);
+    std::vector<uint32_t> owner(cols, none);
+    std::vector<uint32_t> remaining(cols);
+    std::vector<uint8_t> hasDown(cols);
+    std::vector<uint64_t> roomRow(rowWords), downRow(rowWords);
+
+    for (uint32_t r = 0; r < rows; r++)
+    {
+        bool last = r + 1 == rows;
+
+        for (uint32_t c = 0; c < cols; c++)
+        {
+            parent[c] = c;
+            if (label[c] == none)
+                continue;
+
+            if (owner[label[c]] == none)
+                owner[label[c]] = c;
+            else
+                parent[c] = owner[label[c]];
+        }
+
+        std::fill(roomRow.begin(), roomRow.end(), ~0ull);
+        openCell(roomRow, 0);
+        for (uint32_t c = 0; c + 1 < cols; c++)
+        {
+            openCell(roomRow, 2 * (c + 1));
+
+            // The last row joins everything still apart
+            uint32_t a = findSet(parent, c);
+            uint32_t b = findSet(parent, c + 1);
+            if (a != b && (last || (rng() & 1)))
+            {
+                parent[b] = a;
+                openCell(roomRow, 2 * c + 1);
+            }
+        }
+        sink(roomRow.data());
+
+        if (last)
+            break;
+
+        // Every set goes down at least once, through its last cell if no
+        // coin flip took it down earlier
+        std::fill(remaining.begin(), remaining.end(), 0);
+        std::fill(hasDown.begin(), hasDown.end(), 0);
+        for (uint32_t c = 0; c < cols; c++)
+        {
+            remaining[findSet(parent, c)]++;
+        }
+
+        std::fill(downRow.begin(), downRow.end(), ~0ull);
+        for (uint32_t c = 0; c < cols; c++)
+        {
+            uint32_t set = findSet(parent, c);
+            remaining[set]--;
+
+            bool down = (rng() & 1) || (remaining[set] == 0 && !hasDown[set]);
+            hasDown[set] |= down;
+            label[c] = down ? set : none;
+            if (down)
+                openCell(downRow, 2 * c);
+        }
+        sink(downRow.data());
+
+        std::fill(owner.begin(), owner.end(), none);
+    }
+}
+
+EllerMaze::EllerMaze(uint32_t width,
+                     uint32_t height)
+    : Maze(width, height)
+{
+    m_generatorName = "Eller";
+}
+
+void EllerMaze::generateRows(uint32_t width,
+                             uint32_t height,
+                             uint32_t seed,
+                             const RowSink& sink)
+{
+    std::mt19937 rng(seed == 0 ? std::random_device{}() : seed);
+    carveRows(roundUpOdd(width), roundUpOdd(height), rng, sink);
+}
+
+bool EllerMaze::saveRows(const std::string& path,
+                         uint32_t width,
+                         uint32_t height,
+                         uint32_t seed)
+{
+    seed = seed == 0 ? std::random_device{}() : seed;
+
+    MazeFileWriter writer;
+    if (!writer.begin(path, roundUpOdd(width), roundUpOdd(height), seed, "Eller"))
+        return false;
+
+    generateRows(width, height, seed, [&writer](const uint64_t* walls)
+    {
+        writer.writeRow(walls);
+    });
+
+    return writer.end();
+}
+
+bool EllerMaze::exportRows(const std::string& path,
+                           uint32_t width,
+                           uint32_t height,
+                           uint32_t seed,
+                           MazeExporter::Format format)
+{
+    BufferedWriter out(path);
+    if (!out.isOpen())
+    {
+        std::cerr << "Unable to open file for export: " << path << std::endl;
+        return false;
+    }
+
+    MazeExporter exporter(out, format);
+    exporter.begin(roundUpOdd(width), roundUpOdd(height));
+    generateRows(width, height, seed, [&exporter](const uint64_t* walls)
+    {
+        exporter.writeRow(walls, nullptr, 0);
+    });
+    exporter.end();
+
+    if (!out.good())
+    {
+        std::cerr << "Failed to export maze: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void EllerMaze::onGenerate()
+{
+    uint32_t y = 0;
+    carveRows(m_width, m_height, m_rng, [this, &y](const uint64_t* walls)
+    {
+        for (uint32_t x = 0; x < m_width; x++)
+        {
+            if (!(walls[x >> 6] & (1ull << (x & 63))))
+                setWall(x, y, false);
+        }
+        y++;
+    });
+}
@@ -0,0 +1,43 @@
+#ifndef ELLERMAZE_H
+#define ELLERMAZE_H
+
+#include "maze.h"
+#include "mazeexporter.h"
+
+#include <functional>
+
+// Eller's algorithm, which carves a perfect maze one row at a time and only
+// keeps the set of each cell in the current row. The rows can be streamed to
+// a file instead of a Maze, so mazes larger than memory can be written.
+class EllerMaze : public Maze
+{
+public:
+    // Receives every row in Maze word layout, width / 64 + 1 words
+    using RowSink = std::function<void(const uint64_t* walls)>;
+
+public:
+    EllerMaze(uint32_t width = 21,
+              uint32_t height = 21);
+
+    // Same rows generate(seed) carves for a maze of this size, even sizes
+    // rounded up the same way. Memory use is O(width).
+    static void generateRows(uint32_t width,
+                             uint32_t height,
+                             uint32_t seed,
+                             const RowSink& sink);
+
+    static bool saveRows(const std::string& path,
+                         uint32_t width,
+                         uint32_t height,
+                         uint32_t seed);
+    static bool exportRows(const std::string& path,
+                           uint32_t width,
+                           uint32_t height,
+                           uint32_t seed,
+                           MazeExporter::Format format);
+
+protected:
+    virtual void onGenerate() override;
+};
+
+#endif // ELLERMAZE_H
@@ -0,0 +1,573 @@
+#include "hpastarpathfinder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+HPAStarPathFinder::HPAStarPathFinder(uint32_t clusterSize, unsigned threadCount)
+    : m_clusterSize(std::max<uint32_t>(clusterSize, 2))
+    , m_pool(threadCount)
+{
+}
+
+HPAStarPathFinder::~HPAStarPathFinder()
+{
+    if (m_listenMaze)
+        m_listenMaze->removeChangeListener(m_listenerId);
+}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+HPAStarPathFinder::findPath(Point start, Point end)
+{
+    beginSearch();
+    listen(getMaze());
+    rebuild();
+
+    const auto& maze = getMaze();
+    if (!maze->isValidCell(start.x, start.y) || maze->isWall(start.x, start.y) ||
+        !maze->isValidCell(end.x, end.y) || maze->isWall(end.x, end.y))
+    {
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+
+    uint32_t startCell = cellIndex(start);
+    uint32_t endCell = cellIndex(end);
+    uint32_t startCluster = clusterOf(startCell);
+    uint32_t endCluster = clusterOf(endCell);
+
+    // Temporary edges from the start out to its cluster's entrances and from
+    // the end cluster's entrances in to the end
+    searchCluster(startCluster, startCell, false, m_startSearch);
+    searchCluster(endCluster, endCell, true, m_endSearch);
+
+    // Entrances are numbered cluster by cluster, start and end come last
+    uint32_t nodeCount = (uint32_t)m_nodeCells.size();
+    uint32_t startNode = nodeCount;
+    uint32_t endNode = nodeCount + 1;
+    m_g.assign(nodeCount + 2, s_infinity);
+    m_parent.resize(nodeCount + 2);
+    m_closed.assign(nodeCount + 2, 0);
+
+    auto cellOf = [&](uint32_t node)
+    {
+        return node == startNode ? startCell : node == endNode ? endCell : m_nodeCells[node];
+    };
+
+    uint32_t minCost = maze->getMinCost();
+    auto heuristic = [&](uint32_t node)
+    {
+        Point p = cellPoint(cellOf(node));
+        return (uint32_t)(std::abs(p.x - end.x) + std::abs(p.y - end.y)) * minCost;
+    };
+
+    std::vector<std::pair<uint32_t, uint32_t>> open; // (f, node) min-heap
+    auto greater = [](const std::pair<uint32_t, uint32_t>& a,
+                      const std::pair<uint32_t, uint32_t>& b)
+    {
+        return a.first > b.first;
+    };
+
+    std::vector<IterationData> iterData;
+    IterationData* it = nullptr;
+    uint32_t current = startNode;
+
+    auto relax = [&](uint32_t next, uint32_t cost)
+    {
+        if (cost == s_infinity || m_closed[next])
+            return;
+
+        uint32_t g = m_g[current] + cost;
+        if (g >= m_g[next])
+            return;
+
+        m_g[next] = g;
+        m_parent[next] = current;
+        open.push_back({g + heuristic(next), next});
+        std::push_heap(open.begin(), open.end(), greater);
+
+        if (it)
+            it->neighbors[cellPoint(cellOf(next))] = g;
+    };
+
+    m_g[startNode] = 0;
+    m_parent[startNode] = startNode;
+    open.push_back({heuristic(startNode), startNode});
+
+    bool found = false;
+    bool stopped = false;
+    while (!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), greater);
+        current = open.back().second;
+        open.pop_back();
+
+        if (m_closed[current])
+            continue;
+        m_closed[current] = 1;
+
+        if (current == endNode)
+        {
+            found = true;
+            break;
+        }
+
+        // Stopped early, the node just popped has the best f left, so the
+        // route to it is the most promising partial path
+        if (shouldStop())
+        {
+            stopped = true;
+            break;
+        }
+
+        uint32_t cell = cellOf(current);
+        if (isTraceEnabled())
+        {
+            iterData.push_back(IterationData());
+            iterData.back().currentPoint = cellPoint(cell);
+            it = &iterData.back();
+        }
+
+        uint32_t cluster = clusterOf(cell);
+        const Cluster& c = m_clusters[cluster];
+        uint32_t offset = m_nodeOffset[cluster];
+        int index = nodeIndex(cluster, cell);
+
+        if (current == startNode)
+        {
+            for (size_t j = 0; j < c.nodes.size(); j++)
+            {
+                relax(offset + j, m_startSearch.dist[localIndex(cluster, c.nodes[j])]);
+            }
+        }
+        else
+        {
+            const uint32_t* row = &c.dist[(size_t)index * c.nodes.size()];
+            for (size_t j = 0; j < c.nodes.size(); j++)
+            {
+                if ((int)j != index)
+                    relax(offset + j, row[j]);
+            }
+        }
+
+        // Steps across the borders into the neighbouring clusters
+        if (index >= 0)
+        {
+            auto cross = [&](const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                             bool inside, uint32_t neighbour)
+            {
+                for (const auto& pair : pairs)
+                {
+                    uint32_t from = inside ? pair.first : pair.second;
+                    uint32_t to = inside ? pair.second : pair.first;
+                    if (from != cell)
+                        continue;
+
+                    Point p = cellPoint(to);
+                    relax(m_nodeOffset[neighbour] + nodeIndex(neighbour, to),
+                          maze->getCost(p.x, p.y));
+                }
+            };
+
+            if (cluster % m_clustersX + 1 < m_clustersX)
+                cross(m_east[cluster], true, cluster + 1);
+            if (cluster / m_clustersX + 1 < m_clustersY)
+                cross(m_south[cluster], true, cluster + m_clustersX);
+            if (cluster % m_clustersX > 0)
+                cross(m_east[cluster - 1], false, cluster - 1);
+            if (cluster >= m_clustersX)
+                cross(m_south[cluster - m_clustersX], false, cluster - m_clustersX);
+        }
+
+        if (cluster == endCluster)
+            relax(endNode, m_endSearch.dist[localIndex(cluster, cell)]);
+
+        it = nullptr;
+    }
+
+    if (!found && !stopped)
+        return std::make_pair(std::vector<Point>(), iterData);
+
+    std::vector<uint32_t> hops;
+    for (uint32_t node = current; node != startNode; node = m_parent[node])
+    {
+        hops.push_back(cellOf(node));
+    }
+    hops.push_back(startCell);
+    std::reverse(hops.begin(), hops.end());
+
+    // A partial path keeps whatever prefix could be refined
+    std::vector<Point> path;
+    if (!refine(hops, path) && found)
+        return std::make_pair(std::vector<Point>(), iterData);
+
+    if (found)
+        setLastStatus(SearchStatus::Found);
+    return std::make_pair(path, iterData);
+}
+
+uint64_t HPAStarPathFinder::getVariant() const
+{
+    return m_clusterSize;
+}
+
+uint32_t HPAStarPathFinder::getClusterSize() const
+{
+    return m_clusterSize;
+}
+
+size_t HPAStarPathFinder::getNodeCount() const
+{
+    return m_nodeCells.size();
+}
+
+size_t HPAStarPathFinder::getLastRebuiltClusters() const
+{
+    return m_lastRebuilt;
+}
+
+void HPAStarPathFinder::listen(const std::shared_ptr<Maze>& maze)
+{
+    if (maze == m_listenMaze)
+        return;
+
+    if (m_listenMaze)
+        m_listenMaze->removeChangeListener(m_listenerId);
+
+    m_listenMaze = maze;
+    m_listenerId = maze->addChangeListener([this](const MazeChange& change)
+    {
+        onMazeChange(change);
+    });
+    m_needsReset = true;
+}
+
+void HPAStarPathFinder::onMazeChange(const MazeChange& change)
+{
+    if (change.type == MazeChange::Type::Reset)
+        m_needsReset = true;
+    if (m_needsReset)
+        return;
+
+    uint32_t cell = (uint32_t)change.y * m_width + (uint32_t)change.x;
+    uint32_t cluster = clusterOf(cell);
+    markCluster(cluster);
+
+    if (change.type != MazeChange::Type::Wall)
+        return;
+
+    // A wall on a cluster edge also changes the entrances of the neighbour
+    // sharing that edge
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    uint32_t cx = cluster % m_clustersX;
+    uint32_t cy = cluster / m_clustersX;
+
+    if (change.x == x0 && cx > 0)
+        markCluster(cluster - 1);
+    if (change.x == x1 - 1 && cx + 1 < m_clustersX)
+        markCluster(cluster + 1);
+    if (change.y == y0 && cy > 0)
+        markCluster(cluster - m_clustersX);
+    if (change.y == y1 - 1 && cy + 1 < m_clustersY)
+        markCluster(cluster + m_clustersX);
+}
+
+void HPAStarPathFinder::markCluster(uint32_t cluster)
+{
+    if (m_dirty[cluster])
+        return;
+
+    m_dirty[cluster] = 1;
+    m_dirtyList.push_back(cluster);
+}
+
+void HPAStarPathFinder::rebuild()
+{
+    if (m_needsReset)
+    {
+        m_needsReset = false;
+        m_width = getMaze()->getWidth();
+        m_height = getMaze()->getHeight();
+        m_clustersX = (m_width + m_clusterSize - 1) / m_clusterSize;
+        m_clustersY = (m_height + m_clusterSize - 1) / m_clusterSize;
+
+        size_t clusterCount = (size_t)m_clustersX * m_clustersY;
+        m_clusters.assign(clusterCount, Cluster());
+        m_east.assign(clusterCount, {});
+        m_south.assign(clusterCount, {});
+        m_dirty.assign(clusterCount, 1);
+        m_dirtyList.resize(clusterCount);
+        for (uint32_t i = 0; i < clusterCount; i++)
+        {
+            m_dirtyList[i] = i;
+        }
+    }
+
+    m_lastRebuilt = m_dirtyList.size();
+    if (m_dirtyList.empty())
+        return;
+
+    // Entrances first, every cluster owns its east and south border, then
+    // the distances, which read the borders of the neighbours too. Clusters
+    // are handed out one at a time as their cost varies a lot.
+    std::atomic<size_t> next(0);
+    auto entrances = [&](unsigned, unsigned)
+    {
+        for (size_t i; (i = next.fetch_add(1)) < m_dirtyList.size();)
+        {
+            findEntrances(m_dirtyList[i]);
+        }
+    };
+
+    auto distances = [&](unsigned, unsigned)
+    {
+        ClusterSearch search;
+        for (size_t i; (i = next.fetch_add(1)) < m_dirtyList.size();)
+        {
+            buildCluster(m_dirtyList[i], search);
+        }
+    };
+
+    if (m_dirtyList.size() > 1)
+    {
+        m_pool.run(entrances);
+        next = 0;
+        m_pool.run(distances);
+    }
+    else
+    {
+        entrances(0, 1);
+        next = 0;
+        distances(0, 1);
+    }
+
+    for (uint32_t cluster : m_dirtyList)
+    {
+        m_dirty[cluster] = 0;
+    }
+    m_dirtyList.clear();
+
+    // Number the entrances again, node counts may have changed anywhere
+    m_nodeOffset.resize(m_clusters.size() + 1);
+    m_nodeCells.clear();
+    for (size_t i = 0; i < m_clusters.size(); i++)
+    {
+        m_nodeOffset[i] = m_nodeCells.size();
+        m_nodeCells.insert(m_nodeCells.end(),
+                           m_clusters[i].nodes.begin(),
+                           m_clusters[i].nodes.end());
+    }
+    m_nodeOffset.back() = m_nodeCells.size();
+}
+
+uint32_t HPAStarPathFinder::clusterOf(uint32_t cell) const
+{
+    uint32_t x = cell % m_width;
+    uint32_t y = cell / m_width;
+    return (y / m_clusterSize) * m_clustersX + x / m_clusterSize;
+}
+
+void HPAStarPathFinder::clusterBounds(uint32_t cluster, int& x0, int& y0, int& x1, int& y1) const
+{
+    x0 = (cluster % m_clustersX) * m_clusterSize;
+    y0 = (cluster / m_clustersX) * m_clusterSize;
+    x1 = std::min(x0 + m_clusterSize, m_width);
+    y1 = std::min(y0 + m_clusterSize, m_height);
+}
+
+void HPAStarPathFinder::findEntrances(uint32_t cluster)
+{
+    const auto& maze = getMaze();
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+
+    auto scan = [&](std::vector<std::pair<uint32_t, uint32_t>>& out, bool east)
+    {
+        out.clear();
+        if (east ? cluster % m_clustersX + 1 >= m_clustersX
+                 : cluster / m_clustersX + 1 >= m_clustersY)
+            return;
+
+        // Cell i of the border inside the cluster and across it
+        auto pairAt = [&](int i)
+        {
+            int x = east ? x1 - 1 : x0 + i;
+            int y = east ? y0 + i : y1 - 1;
+            uint32_t inside = (uint32_t)y * m_width + x;
+            return std::make_pair(inside, east ? inside + 1 : inside + m_width);
+        };
+
+        int length = east ? y1 - y0 : x1 - x0;
+        int runStart = -1;
+        for (int i = 0; i <= length; i++)
+        {
+            bool open = false;
+            if (i < length)
+            {
+                auto pair = pairAt(i);
+                open = !maze->isWall(pair.first % m_width, pair.first / m_width) &&
+                       !maze->isWall(pair.second % m_width, pair.second / m_width);
+            }
+
+            if (open && runStart < 0)
+            {
+                runStart = i;
+            }
+            else if (!open && runStart >= 0)
+            {
+                int runEnd = i - 1;
+                if ((uint32_t)(runEnd - runStart + 1) > s_longRun)
+                {
+                    out.push_back(pairAt(runStart));
+                    out.push_back(pairAt(runEnd));
+                }
+                else
+                {
+                    out.push_back(pairAt((runStart + runEnd) / 2));
+                }
+                runStart = -1;
+            }
+        }
+    };
+
+    scan(m_east[cluster], true);
+    scan(m_south[cluster], false);
+}
+
+void HPAStarPathFinder::buildCluster(uint32_t cluster, ClusterSearch& search)
+{
+    Cluster& c = m_clusters[cluster];
+    c.nodes.clear();
+
+    for (const auto& pair : m_east[cluster])
+        c.nodes.push_back(pair.first);
+    for (const auto& pair : m_south[cluster])
+        c.nodes.push_back(pair.first);
+    if (cluster % m_clustersX > 0)
+    {
+        for (const auto& pair : m_east[cluster - 1])
+            c.nodes.push_back(pair.second);
+    }
+    if (cluster >= m_clustersX)
+    {
+        for (const auto& pair : m_south[cluster - m_clustersX])
+            c.nodes.push_back(pair.second);
+    }
+
+    // A corner cell can be an entrance on two borders
+    std::sort(c.nodes.begin(), c.nodes.end());
+    c.nodes.erase(std::unique(c.nodes.begin(), c.nodes.end()), c.nodes.end());
+
+    size_t count = c.nodes.size();
+    c.dist.resize(count * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        searchCluster(cluster, c.nodes[i], false, search);
+        for (size_t j = 0; j < count; j++)
+        {
+            c.dist[i * count + j] = search.dist[localIndex(cluster, c.nodes[j])];
+        }
+    }
+}
+
+void HPAStarPathFinder::searchCluster(uint32_t cluster, uint32_t source, bool reverse,
+                                      ClusterSearch& search) const
+{
+    const auto& maze = getMaze();
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    int width = x1 - x0;
+
+    search.dist.assign((size_t)width * (y1 - y0), s_infinity);
+    search.cameFrom.resize(search.dist.size());
+    search.open.clear();
+
+    uint32_t local = localIndex(cluster, source);
+    search.dist[local] = 0;
+    search.open.push(0, local);
+
+    while (!search.open.empty())
+    {
+        auto top = search.open.pop();
+        if (top.first > search.dist[top.second])
+            continue;
+
+        int x = x0 + top.second % width;
+        int y = y0 + top.second / width;
+        uint32_t here = maze->getCost(x, y);
+
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            int nx = x + Maze::dx[i];
+            int ny = y + Maze::dy[i];
+            if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1 || maze->isWall(nx, ny))
+                continue;
+
+            // Costs are paid on entering a cell, so a reversed search pays
+            // for the cell it comes from
+            uint32_t g = top.first + (reverse ? here : maze->getCost(nx, ny));
+            uint32_t next = (ny - y0) * width + (nx - x0);
+            if (g < search.dist[next])
+            {
+                search.dist[next] = g;
+                search.cameFrom[next] = top.second;
+                search.open.push(g, next);
+            }
+        }
+    }
+}
+
+uint32_t HPAStarPathFinder::localIndex(uint32_t cluster, uint32_t cell) const
+{
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    return (cell / m_width - y0) * (x1 - x0) + (cell % m_width - x0);
+}
+
+int HPAStarPathFinder::nodeIndex(uint32_t cluster, uint32_t cell) const
+{
+    const auto& nodes = m_clusters[cluster].nodes;
+    auto it = std::lower_bound(nodes.begin(), nodes.end(), cell);
+    if (it == nodes.end() || *it != cell)
+        return -1;
+    return (int)(it - nodes.begin());
+}
+
+bool HPAStarPathFinder::refine(const std::vector<uint32_t>& hops, std::vector<Point>& path)
+{
+    path.push_back(cellPoint(hops.front()));
+
+    for (size_t i = 1; i < hops.size(); i++)
+    {
+        uint32_t from = hops[i - 1];
+        uint32_t to = hops[i];
+        uint32_t cluster = clusterOf(from);
+
+        if (clusterOf(to) != cluster)
+        {
+            path.push_back(cellPoint(to));
+            continue;
+        }
+
+        // Hops inside a cluster are searched again, only their cost was kept
+        searchCluster(cluster, from, false, m_refineSearch);
+        uint32_t local = localIndex(cluster, to);
+        if (m_refineSearch.dist[local] == s_infinity)
+            return false;
+
+        int x0, y0, x1, y1;
+        clusterBounds(cluster, x0, y0, x1, y1);
+        int width = x1 - x0;
+
+        size_t mid = path.size();
+        uint32_t source = localIndex(cluster, from);
+        for (; local != source; local = m_refineSearch.cameFrom[local])
+        {
+            path.push_back(Point{x0 + (int)(local % width), y0 + (int)(local / width)});
+        }
+        std::reverse(path.begin() + mid, path.end());
+    }
+
+    return true;
+}
@@ -0,0 +1,108 @@
+#ifndef HPASTARPATHFINDER_H
+#define HPASTARPATHFINDER_H
+
+#include "pathfinder.h"
+#include "bucketqueue.h"
+#include "threadpool.h"
+
+// Hierarchical A* (HPA*) for very large grids.
+// The grid is cut into square clusters. Wherever two clusters share an open
+// border there is an entrance, and within every cluster the distances between
+// its entrances are precomputed in parallel. A query connects start and end
+// to the entrances of their clusters, runs A* over this small graph and then
+// refines each hop with a search inside one cluster. Paths are near-optimal,
+// as every hop stays inside its cluster.
+// The finder listens to its maze and rebuilds only the clusters a wall or
+// cost edit touched.
+class HPAStarPathFinder : public PathFinder
+{
+public:
+    // Zero threads picks one per hardware thread
+    explicit HPAStarPathFinder(uint32_t clusterSize = 32, unsigned threadCount = 0);
+    HPAStarPathFinder(const HPAStarPathFinder&) = delete;
+    HPAStarPathFinder& operator=(const HPAStarPathFinder&) = delete;
+    ~HPAStarPathFinder();
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    // Paths are shortest between entrances, so they depend on the clusters
+    virtual uint64_t getVariant() const override;
+
+    uint32_t getClusterSize() const;
+    // Entrance cells over all clusters
+    size_t getNodeCount() const;
+    // Clusters rebuilt before the last query, all of them after a reset
+    size_t getLastRebuiltClusters() const;
+
+private:
+    struct Cluster
+    {
+        std::vector<uint32_t> nodes; // Entrance cells, sorted
+        std::vector<uint32_t> dist;  // Row per node, costs to every other node
+    };
+
+    // Per-thread buffers for searches inside one cluster
+    struct ClusterSearch
+    {
+        std::vector<uint32_t> dist;     // By cell inside the cluster
+        std::vector<uint32_t> cameFrom; // By cell inside the cluster
+        BucketQueue open;
+    };
+
+    void listen(const std::shared_ptr<Maze>& maze);
+    void onMazeChange(const MazeChange& change);
+    void markCluster(uint32_t cluster);
+    void rebuild();
+
+    uint32_t clusterOf(uint32_t cell) const;
+    void clusterBounds(uint32_t cluster, int& x0, int& y0, int& x1, int& y1) const;
+    void findEntrances(uint32_t cluster);
+    void buildCluster(uint32_t cluster, ClusterSearch& search);
+
+    // Costs from source to every cell of the cluster without leaving it.
+    // Reversed, they are costs from every cell to source instead.
+    void searchCluster(uint32_t cluster, uint32_t source, bool reverse,
+                       ClusterSearch& search) const;
+    uint32_t localIndex(uint32_t cluster, uint32_t cell) const;
+    int nodeIndex(uint32_t cluster, uint32_t cell) const;
+
+    bool refine(const std::vector<uint32_t>& hops, std::vector<Point>& path);
+
+private:
+    static constexpr uint32_t s_infinity = UINT32_MAX;
+    // Open border runs longer than this get an entrance at both ends
+    static constexpr uint32_t s_longRun = 6;
+
+    uint32_t m_clusterSize;
+    ThreadPool m_pool;
+
+    std::shared_ptr<Maze> m_listenMaze;
+    uint32_t m_listenerId = 0;
+    bool m_needsReset = true;
+
+    uint32_t m_width = 0, m_height = 0;
+    uint32_t m_clustersX = 0, m_clustersY = 0;
+    std::vector<Cluster> m_clusters;
+    // Entrance pairs on the east and south border of each cluster, the first
+    // cell inside the cluster and the second in its neighbour
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> m_east, m_south;
+
+    std::vector<uint8_t> m_dirty;         // Per cluster
+    std::vector<uint8_t> m_dirtyBorders;  // Per cluster, bit 0 east, bit 1 south
+    std::vector<uint32_t> m_dirtyList;
+    size_t m_lastRebuilt = 0;
+
+    std::vector<uint32_t> m_nodeOffset; // Per cluster, number of its first entrance
+    std::vector<uint32_t> m_nodeCells;  // By entrance number
+
+    // Search over the entrances, kept between queries
+    std::vector<uint32_t> m_g;
+    std::vector<uint32_t> m_parent;
+    std::vector<uint8_t> m_closed;
+
+    ClusterSearch m_startSearch, m_endSearch, m_refineSearch;
+};
+
+#endif // HPASTARPATHFINDER_H
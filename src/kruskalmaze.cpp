@@ -6,14 +6,13 @@ KruskalMaze::KruskalMaze(uint32_t width,
                                    uint32_t height)
     : Maze(width, height)
 {
+    m_generatorName = "Kruskal";
 }
 
-void KruskalMaze::generate(uint32_t seed)
+void KruskalMaze::onGenerate()
 {
-    Maze::generate(seed);
-
     // Create a list of all possible walls
-    std::vector<Wall> walls;
+    m_walls.clear();
     for (int y = 0; y < getHeight(); y += 2)
     {
         for (int x = 0; x < getWidth(); x += 2)
@@ -21,45 +20,44 @@ void KruskalMaze::generate(uint32_t seed)
             // Add horizontal walls
             if (x + 2 < getWidth())
             {
-                walls.emplace_back(x, y, x + 2, y, x + 1, y);
+                m_walls.emplace_back(x, y, x + 2, y, x + 1, y);
             }
             // Add vertical walls
             if (y + 2 < getHeight())
             {
-                walls.emplace_back(x, y, x, y + 2, x, y + 1);
+                m_walls.emplace_back(x, y, x, y + 2, x, y + 1);
             }
         }
     }
 
     // Create cells
-    auto& grid = const_cast<std::vector<std::vector<int>>&>(getGrid());
     for (int y = 0; y < getHeight(); y += 2)
     {
         for (int x = 0; x < getWidth(); x += 2)
         {
-            grid[y][x] = 0;
+            setWall(x, y, false);
         }
     }
 
     // Shuffle walls
-    std::shuffle(walls.begin(), walls.end(), m_rng);
+    std::shuffle(m_walls.begin(), m_walls.end(), m_rng);
 
     // Initialize disjoint set
     int cellCount = ((getWidth() + 1) / 2) * ((getHeight() + 1) / 2);
-    DisjointSet ds(cellCount);
+    m_sets.reset(cellCount);
 
     // Process each wall
-    for (const Wall& wall : walls)
+    for (const Wall& wall : m_walls)
     {
         // Convert coordinates to cell indices
         int cell1 = (wall.y1 / 2) * ((getWidth() + 1) / 2) + (wall.x1 / 2);
         int cell2 = (wall.y2 / 2) * ((getWidth() + 1) / 2) + (wall.x2 / 2);
 
         // If cells are not connected, remove wall
-        if (!ds.connected(cell1, cell2))
+        if (!m_sets.connected(cell1, cell2))
         {
-            grid[wall.wy][wall.wx] = 0;  // Remove wall
-            ds.unite(cell1, cell2);      // Unite cells
+            setWall(wall.wx, wall.wy, false); // Remove wall
+            m_sets.unite(cell1, cell2);      // Unite cells
         }
     }
 }
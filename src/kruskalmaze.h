@@ -8,8 +8,11 @@ class KruskalMaze : public Maze
     class DisjointSet
     {
     public:
-        explicit DisjointSet(int size) : parent(size), rank(size, 0)
+        // Every element in a set of its own, reusing the memory of the last sets
+        void reset(int size)
         {
+            parent.resize(size);
+            rank.assign(size, 0);
             for (int i = 0; i < size; i++)
             {
                 parent[i] = i;
@@ -71,7 +74,13 @@ public:
     KruskalMaze(uint32_t width = 21,
                 uint32_t height = 21);
 
-    virtual void generate(uint32_t seed) override;
+protected:
+    virtual void onGenerate() override;
+
+private:
+    // Kept between calls, so regenerating reuses their capacity
+    std::vector<Wall> m_walls;
+    DisjointSet m_sets;
 };
 
 #endif // KRUSKALMAZE_H
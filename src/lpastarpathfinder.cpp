@@ -0,0 +1,284 @@
+#include "lpastarpathfinder.h"
+
+#include <algorithm>
+
+LPAStarPathFinder::LPAStarPathFinder() {}
+
+LPAStarPathFinder::~LPAStarPathFinder()
+{
+    if (m_listenMaze)
+        m_listenMaze->removeChangeListener(m_listenerId);
+}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+LPAStarPathFinder::findPath(Point start, Point end)
+{
+    beginSearch();
+    listen(getMaze());
+
+    const auto& maze = getMaze();
+    if (!maze->isValidCell(start.x, start.y) || maze->isWall(start.x, start.y) ||
+        !maze->isValidCell(end.x, end.y) || maze->isWall(end.x, end.y))
+    {
+        m_needsReset = true;
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+
+    // A cost edit can lower the cheapest cost, which changes the heuristic
+    m_repaired = !m_needsReset && start == m_start && end == m_end &&
+                 maze->getMinCost() == m_heuristicScale;
+
+    if (m_repaired)
+    {
+        // An edited cell changes its own rhs and is a different
+        // predecessor for its neighbours now
+        for (uint32_t cell : m_changed)
+        {
+            updateVertex(cell);
+            for (const Point& n : getNeighbors(cellPoint(cell)))
+            {
+                updateVertex(cellIndex(n));
+            }
+        }
+    }
+    else
+    {
+        reset(start, end);
+    }
+    m_changed.clear();
+
+    std::vector<IterationData> iterData;
+    if (!computeShortestPath(isTraceEnabled() ? &iterData : nullptr))
+        return std::make_pair(extractPath(closestSettled()), iterData);
+
+    if (m_g[cellIndex(end)] == s_infinity)
+        return std::make_pair(std::vector<Point>(), iterData);
+
+    setLastStatus(SearchStatus::Found);
+    return std::make_pair(extractPath(cellIndex(end)), iterData);
+}
+
+bool LPAStarPathFinder::supportsTopology(Maze::Topology) const
+{
+    return true;
+}
+
+bool LPAStarPathFinder::wasRepaired() const
+{
+    return m_repaired;
+}
+
+void LPAStarPathFinder::listen(const std::shared_ptr<Maze>& maze)
+{
+    if (maze == m_listenMaze)
+        return;
+
+    if (m_listenMaze)
+        m_listenMaze->removeChangeListener(m_listenerId);
+
+    m_listenMaze = maze;
+    m_listenerId = maze->addChangeListener([this](const MazeChange& change)
+    {
+        onMazeChange(change);
+    });
+    m_needsReset = true;
+}
+
+void LPAStarPathFinder::onMazeChange(const MazeChange& change)
+{
+    if (change.type == MazeChange::Type::Reset)
+    {
+        m_needsReset = true;
+        m_changed.clear();
+        return;
+    }
+
+    if (!m_needsReset)
+        m_changed.push_back(cellIndex(Point{change.x, change.y}));
+}
+
+void LPAStarPathFinder::reset(Point start, Point end)
+{
+    m_start = start;
+    m_end = end;
+    m_heuristicScale = getMaze()->getMinCost();
+    m_needsReset = false;
+
+    m_g.assign(cellCount(), s_infinity);
+    m_rhs.assign(cellCount(), s_infinity);
+    m_inOpen.assign(cellCount(), 0);
+    m_open.clear();
+
+    uint32_t startCell = cellIndex(start);
+    m_rhs[startCell] = 0;
+    updateVertex(startCell);
+}
+
+LPAStarPathFinder::OpenEntry LPAStarPathFinder::calculateKey(uint32_t cell) const
+{
+    Point p = cellPoint(cell);
+    uint32_t h = distanceBound(p, m_end) * m_heuristicScale;
+    uint32_t best = std::min(m_g[cell], m_rhs[cell]);
+    return OpenEntry{(uint64_t)best + h, best, cell};
+}
+
+uint32_t LPAStarPathFinder::calculateRhs(uint32_t cell) const
+{
+    Point p = cellPoint(cell);
+    if (getMaze()->isWall(p.x, p.y))
+        return s_infinity;
+
+    uint32_t best = s_infinity;
+    for (const Point& n : getNeighbors(p))
+    {
+        uint32_t g = m_g[cellIndex(n)];
+        if (g != s_infinity)
+            best = std::min(best, g + stepCost(n, p));
+    }
+
+    return best;
+}
+
+void LPAStarPathFinder::updateVertex(uint32_t cell)
+{
+    if (cell != cellIndex(m_start))
+        m_rhs[cell] = calculateRhs(cell);
+
+    // Inconsistent cells are (re)queued, stale entries are skipped on pop
+    m_inOpen[cell] = m_g[cell] != m_rhs[cell];
+    if (m_inOpen[cell])
+    {
+        m_open.push_back(calculateKey(cell));
+        std::push_heap(m_open.begin(), m_open.end(), openCompare);
+    }
+}
+
+bool LPAStarPathFinder::computeShortestPath(std::vector<IterationData>* trace)
+{
+    uint32_t endCell = cellIndex(m_end);
+
+    while (!m_open.empty())
+    {
+        OpenEntry top = m_open.front();
+        OpenEntry current = calculateKey(top.cell);
+        if (!m_inOpen[top.cell] ||
+            top.primary != current.primary || top.secondary != current.secondary)
+        {
+            std::pop_heap(m_open.begin(), m_open.end(), openCompare);
+            m_open.pop_back();
+            continue;
+        }
+
+        // Done once nothing queued can still improve the end
+        OpenEntry endKey = calculateKey(endCell);
+        if (!openCompare(endKey, top) && m_g[endCell] == m_rhs[endCell])
+            break;
+
+        if (shouldStop())
+            return false;
+
+        std::pop_heap(m_open.begin(), m_open.end(), openCompare);
+        m_open.pop_back();
+        m_inOpen[top.cell] = 0;
+
+        uint32_t cell = top.cell;
+        Point p = cellPoint(cell);
+        if (m_g[cell] > m_rhs[cell])
+        {
+            // Overconsistent, a shorter route was found
+            m_g[cell] = m_rhs[cell];
+        }
+        else
+        {
+            // Underconsistent, the old route got longer or was cut
+            m_g[cell] = s_infinity;
+            updateVertex(cell);
+        }
+
+        IterationData it;
+        it.currentPoint = p;
+        for (const Point& n : getNeighbors(p))
+        {
+            uint32_t next = cellIndex(n);
+            updateVertex(next);
+            if (trace && m_inOpen[next])
+                it.neighbors[n] = (int)std::min<uint64_t>(calculateKey(next).primary, INT32_MAX);
+        }
+
+        if (trace)
+            trace->push_back(std::move(it));
+    }
+
+    return true;
+}
+
+uint32_t LPAStarPathFinder::closestSettled() const
+{
+    // Settled cells have the g they would end with, the start before its
+    // first expansion has none and is the fallback
+    uint32_t best = cellIndex(m_start);
+    uint64_t bestKey = UINT64_MAX;
+    for (uint32_t cell = 0; cell < cellCount(); cell++)
+    {
+        if (m_g[cell] == s_infinity || m_g[cell] != m_rhs[cell])
+            continue;
+
+        // Closest to the end first, then the cheapest to reach
+        uint64_t key = (uint64_t)distanceBound(cellPoint(cell), m_end) << 32 | m_g[cell];
+        if (key < bestKey)
+        {
+            best = cell;
+            bestKey = key;
+        }
+    }
+
+    return best;
+}
+
+std::vector<Point> LPAStarPathFinder::extractPath(uint32_t target) const
+{
+    // Walk from the target down the g values, every step strictly decreases
+    // g. The step to take is the cheapest predecessor, which with equal move
+    // weights is the neighbour of lowest g.
+    uint32_t startCell = cellIndex(m_start);
+    uint32_t cell = target;
+
+    std::vector<Point> path;
+    path.push_back(cellPoint(target));
+    while (cell != startCell)
+    {
+        Point p = cellPoint(cell);
+        uint32_t best = cell;
+        uint64_t bestCost = UINT64_MAX;
+        for (const Point& n : getNeighbors(p))
+        {
+            uint32_t next = cellIndex(n);
+            if (m_g[next] >= m_g[cell])
+                continue;
+
+            uint64_t cost = (uint64_t)m_g[next] + stepCost(n, p);
+            if (cost < bestCost)
+            {
+                best = next;
+                bestCost = cost;
+            }
+        }
+
+        if (best == cell)
+            return std::vector<Point>();
+
+        cell = best;
+        path.push_back(cellPoint(cell));
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool LPAStarPathFinder::openCompare(const OpenEntry& a, const OpenEntry& b)
+{
+    if (a.primary != b.primary)
+        return a.primary > b.primary;
+    return a.secondary > b.secondary;
+}
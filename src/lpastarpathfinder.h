@@ -0,0 +1,71 @@
+#ifndef LPASTARPATHFINDER_H
+#define LPASTARPATHFINDER_H
+
+#include "pathfinder.h"
+
+// Lifelong Planning A*.
+// The search state is kept between calls and the finder listens to its
+// maze. Asking for the same start and end again after wall or cost edits
+// only revisits the cells whose distances the edits changed. Any other query,
+// or a regenerated maze, starts over.
+class LPAStarPathFinder : public PathFinder
+{
+public:
+    LPAStarPathFinder();
+    LPAStarPathFinder(const LPAStarPathFinder&) = delete;
+    LPAStarPathFinder& operator=(const LPAStarPathFinder&) = delete;
+    ~LPAStarPathFinder();
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    virtual bool supportsTopology(Maze::Topology topology) const override;
+
+    // False if the last findPath started from scratch
+    bool wasRepaired() const;
+
+private:
+    struct OpenEntry
+    {
+        uint64_t primary;   // min(g, rhs) + h
+        uint32_t secondary; // min(g, rhs)
+        uint32_t cell;
+    };
+
+    static bool openCompare(const OpenEntry& a, const OpenEntry& b);
+
+    void listen(const std::shared_ptr<Maze>& maze);
+    void onMazeChange(const MazeChange& change);
+    void reset(Point start, Point end);
+
+    OpenEntry calculateKey(uint32_t cell) const;
+    uint32_t calculateRhs(uint32_t cell) const;
+    void updateVertex(uint32_t cell);
+    // Returns false if a search limit stopped it, the state is kept so the
+    // next call carries on
+    bool computeShortestPath(std::vector<IterationData>* trace);
+    // The settled cell closest to the end, for a stopped search
+    uint32_t closestSettled() const;
+    std::vector<Point> extractPath(uint32_t target) const;
+
+private:
+    static constexpr uint32_t s_infinity = UINT32_MAX;
+
+    std::shared_ptr<Maze> m_listenMaze;
+    uint32_t m_listenerId = 0;
+    std::vector<uint32_t> m_changed; // Cells edited since the last call
+    bool m_needsReset = true;
+    bool m_repaired = false;
+
+    Point m_start = { -1, -1 };
+    Point m_end = { -1, -1 };
+    int m_heuristicScale = 1;
+
+    std::vector<uint32_t> m_g;
+    std::vector<uint32_t> m_rhs;    // One-step lookahead of g
+    std::vector<uint8_t> m_inOpen;
+    std::vector<OpenEntry> m_open;  // Min-heap with lazy deletion
+};
+
+#endif // LPASTARPATHFINDER_H
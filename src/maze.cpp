@@ -1,25 +1,68 @@
 #include "maze.h"
+#include "mazeexporter.h"
 
+#include <algorithm>
 #include <iostream>
 
+// splitmix64 finalizer, spreads a cell index over the whole hash
+static uint64_t mixCell(uint64_t index)
+{
+    index += 0x9e3779b97f4a7c15ull;
+    index = (index ^ (index >> 30)) * 0xbf58476d1ce4e5b9ull;
+    index = (index ^ (index >> 27)) * 0x94d049bb133111ebull;
+    return index ^ (index >> 31);
+}
+
 Maze::Maze(uint32_t width, uint32_t height)
 {
     m_width = width % 2 == 0 ? width + 1 : width;
     m_height = height % 2 == 0 ? height + 1 : height;
 
-    m_grid = std::vector(m_height, std::vector(m_width, 1));
+    clear();
 }
 
 void Maze::generate(uint32_t seed)
 {
-    clear();
+    if (isReadOnly())
+    {
+        std::cerr << "Cannot generate a read-only maze!" << std::endl;
+        return;
+    }
 
-    m_rng.seed(seed == 0 ? std::random_device{}() : seed);
+    clearCells();
+
+    m_seed = seed == 0 ? std::random_device{}() : seed;
+    m_rng.seed(m_seed);
+    onGenerate();
+    if (m_braidRatio > 0.0f)
+        braid();
+
+    notify(MazeChange{MazeChange::Type::Reset});
 }
 
 void Maze::clear()
 {
-    m_grid = std::vector(m_height, std::vector(m_width, 1));
+    if (isReadOnly())
+    {
+        std::cerr << "Cannot clear a read-only maze!" << std::endl;
+        return;
+    }
+
+    clearCells();
+    notify(MazeChange{MazeChange::Type::Reset});
+}
+
+void Maze::clearCells()
+{
+    m_rowWords = m_width / 64 + 1;
+    m_cells.assign((size_t)m_rowWords * (m_height + 2), ~0ull);
+    m_words = m_cells.data() + m_rowWords;
+    if (m_layout == Layout::Tiled)
+        buildTiles();
+    m_openCellsHash = 0;
+    m_revision++;
+    m_treeIndex.reset();
+    dropCosts();
 }
 
 bool Maze::isValidCell(int cx, int cy) const
@@ -29,13 +72,245 @@ bool Maze::isValidCell(int cx, int cy) const
 
 bool Maze::isWall(int cx, int cy) const
 {
-    return m_grid[cy][cx] == 1;
+    if (m_layout == Layout::Tiled)
+    {
+        uint64_t tile = m_tileWords[(size_t)(cy >> 3) * m_tilesX + (cx >> 3)];
+        return (tile >> (((cy & 7) << 3) | (cx & 7))) & 1;
+    }
+
+    return (m_words[(size_t)cy * m_rowWords + (cx >> 6)] >> (cx & 63)) & 1;
+}
+
+uint8_t Maze::getOpenSides(int cx, int cy) const
+{
+    // Off the left edge x >> 6 is -1, which reads the spare bit of the row
+    // above, or of the wall row for row 0
+    auto bit = [](const uint64_t* row, int x) -> uint8_t
+    {
+        return (row[x >> 6] >> (x & 63)) & 1;
+    };
+
+    uint8_t walls;
+    if (m_layout == Layout::Tiled)
+    {
+        auto tileBit = [this](int x, int y) -> uint8_t
+        {
+            uint64_t tile = m_tileWords[(ptrdiff_t)(y >> 3) * m_tilesX + (x >> 3)];
+            return (tile >> (((y & 7) << 3) | (x & 7))) & 1;
+        };
+
+        walls = tileBit(cx, cy + 1) |
+                tileBit(cx + 1, cy) << 1 |
+                tileBit(cx, cy - 1) << 2 |
+                tileBit(cx - 1, cy) << 3;
+    }
+    else if (!isReadOnly())
+    {
+        const uint64_t* row = m_words + (size_t)cy * m_rowWords;
+        walls = bit(row + m_rowWords, cx) |
+                bit(row, cx + 1) << 1 |
+                bit(row - m_rowWords, cx) << 2 |
+                bit(row, cx - 1) << 3;
+    }
+    else
+    {
+        walls = 0;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            int nx = cx + dx[i];
+            int ny = cy + dy[i];
+            walls |= (!isValidCell(nx, ny) || isWall(nx, ny)) << i;
+        }
+    }
+
+    return ~walls & 0xf;
+}
+
+bool Maze::isReadOnly() const
+{
+    return m_mapping != nullptr;
 }
 
 void Maze::setSize(uint32_t width, uint32_t height)
 {
+    if (isReadOnly())
+    {
+        std::cerr << "Cannot resize a read-only maze!" << std::endl;
+        return;
+    }
+
     m_width = width;
     m_height = height;
+    clear();
+}
+
+void Maze::setLayout(Layout layout)
+{
+    if (layout == m_layout)
+        return;
+
+    m_layout = layout;
+    if (m_layout == Layout::Tiled)
+        buildTiles();
+    else
+    {
+        m_tiles = std::vector<uint64_t>();
+        m_tileWords = nullptr;
+    }
+}
+
+Maze::Layout Maze::getLayout() const
+{
+    return m_layout;
+}
+
+void Maze::setTopology(Topology topology)
+{
+    if (topology == m_topology)
+        return;
+
+    m_topology = topology;
+    m_revision++;
+    notify(MazeChange{MazeChange::Type::Reset});
+}
+
+Maze::Topology Maze::getTopology() const
+{
+    return m_topology;
+}
+
+void Maze::buildTiles()
+{
+    m_tilesX = m_width / 8 + 1;
+    uint32_t tilesY = (m_height + 7) / 8;
+    m_tiles.assign((size_t)m_tilesX * (tilesY + 2), ~0ull);
+    m_tileWords = m_tiles.data() + m_tilesX;
+
+    // Open cells only, everything past the edges stays wall
+    for (uint32_t y = 0; y < m_height; y++)
+    {
+        const uint64_t* row = m_words + (size_t)y * m_rowWords;
+        uint64_t* tileRow = m_tileWords + (size_t)(y >> 3) * m_tilesX;
+        for (uint32_t x = 0; x < m_width; x++)
+        {
+            if (!((row[x >> 6] >> (x & 63)) & 1))
+                tileRow[x >> 3] &= ~(1ull << (((y & 7) << 3) | (x & 7)));
+        }
+    }
+}
+
+void Maze::setBraidRatio(float ratio)
+{
+    m_braidRatio = std::min(std::max(ratio, 0.0f), 1.0f);
+}
+
+float Maze::getBraidRatio() const
+{
+    return m_braidRatio;
+}
+
+void Maze::braid()
+{
+    // Rooms sit on even coordinates with a wall cell between neighbours.
+    // A room with one open side is a dead end.
+    auto openSides = [this](int x, int y)
+    {
+        int count = 0;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            int wx = x + dx[i];
+            int wy = y + dy[i];
+            count += isValidCell(wx, wy) && !isWall(wx, wy);
+        }
+        return count;
+    };
+
+    std::bernoulli_distribution pick(m_braidRatio);
+
+    // One pass in row order. Dead ends are counted as they are reached, so a
+    // room already joined to an earlier one is no longer picked.
+    for (int y = 0; y < (int)m_height; y += 2)
+    {
+        for (int x = 0; x < (int)m_width; x += 2)
+        {
+            if (isWall(x, y) || openSides(x, y) != 1 || !pick(m_rng))
+                continue;
+
+            // Closed sides leading to another room, those into a dead end
+            // first since one opening then removes two of them
+            uint8_t candidates[4];
+            uint8_t count = 0, deadEnds = 0;
+            for (uint8_t i = 0; i < 4; i++)
+            {
+                int nx = x + dx[i] * 2;
+                int ny = y + dy[i] * 2;
+                if (!isValidCell(nx, ny) || !isWall(x + dx[i], y + dy[i]))
+                    continue;
+
+                if (openSides(nx, ny) == 1)
+                {
+                    candidates[count++] = candidates[deadEnds];
+                    candidates[deadEnds++] = i;
+                }
+                else
+                {
+                    candidates[count++] = i;
+                }
+            }
+
+            if (count == 0)
+                continue;
+
+            uint8_t range = deadEnds > 0 ? deadEnds : count;
+            uint8_t dir = candidates[std::uniform_int_distribution<int>(0, range - 1)(m_rng)];
+            setWall(x + dx[dir], y + dy[dir], false);
+        }
+    }
+}
+
+bool Maze::toggleWall(int cx, int cy)
+{
+    if (isReadOnly())
+    {
+        std::cerr << "Cannot edit a read-only maze!" << std::endl;
+        return false;
+    }
+
+    if (!isValidCell(cx, cy))
+        return false;
+
+    setWall(cx, cy, !isWall(cx, cy));
+    m_revision++;
+    m_treeIndex.reset();
+    notify(MazeChange{MazeChange::Type::Wall, cx, cy});
+    return true;
+}
+
+uint32_t Maze::addChangeListener(ChangeListener listener)
+{
+    uint32_t id = m_nextListenerId++;
+    m_listeners.push_back({id, std::move(listener)});
+    return id;
+}
+
+void Maze::removeChangeListener(uint32_t id)
+{
+    for (size_t i = 0; i < m_listeners.size(); i++)
+    {
+        if (m_listeners[i].first == id)
+        {
+            m_listeners.erase(m_listeners.begin() + i);
+            return;
+        }
+    }
+}
+
+void Maze::notify(const MazeChange& change) const
+{
+    for (const auto& listener : m_listeners)
+    {
+        listener.second(change);
+    }
 }
 
 uint32_t Maze::getWidth() const
@@ -48,20 +323,204 @@ uint32_t Maze::getHeight() const
     return m_height;
 }
 
-const
-std::vector<std::vector<int>>& Maze::getGrid() const
+const uint64_t* Maze::getWords() const
 {
-    return m_grid;
+    return m_words;
 }
 
-void Maze::print() const
+uint32_t Maze::getRowWords() const
+{
+    return m_rowWords;
+}
+
+const uint64_t* Maze::getTileWords() const
+{
+    return m_tileWords;
+}
+
+uint32_t Maze::getTilesPerRow() const
+{
+    return m_tilesX;
+}
+
+bool Maze::hasCosts() const
+{
+    return !m_costs.empty();
+}
+
+uint8_t Maze::getCost(int cx, int cy) const
+{
+    return m_costs.empty() ? 1 : m_costs[(size_t)cy * m_width + cx];
+}
+
+const uint8_t* Maze::getCosts() const
+{
+    return m_costs.empty() ? nullptr : m_costs.data();
+}
+
+uint8_t Maze::getMinCost() const
+{
+    if (m_costs.empty())
+        return 1;
+
+    uint32_t cost = 1;
+    while (m_costHistogram[cost] == 0)
+    {
+        cost++;
+    }
+    return cost;
+}
+
+uint8_t Maze::getMaxCost() const
+{
+    if (m_costs.empty())
+        return 1;
+
+    uint32_t cost = 255;
+    while (m_costHistogram[cost] == 0)
+    {
+        cost--;
+    }
+    return cost;
+}
+
+void Maze::setCost(int cx, int cy, uint8_t cost)
+{
+    if (!isValidCell(cx, cy))
+        return;
+
+    if (storeCost(cx, cy, cost))
+        notify(MazeChange{MazeChange::Type::Cost, cx, cy});
+}
+
+bool Maze::storeCost(int cx, int cy, uint8_t cost)
+{
+    // Zero would make moves free and break the A* heuristic
+    cost = cost == 0 ? 1 : cost;
+
+    if (m_costs.empty())
+    {
+        if (cost == 1)
+            return false;
+
+        m_costs.assign((size_t)m_width * m_height, 1);
+        m_costHistogram.fill(0);
+        m_costHistogram[1] = m_costs.size();
+    }
+
+    size_t index = (size_t)cy * m_width + cx;
+    uint8_t previous = m_costs[index];
+    if (previous == cost)
+        return false;
+
+    // Cost 1 cells do not contribute, so an all-ones layer hashes as none
+    if (previous != 1)
+        m_costHash ^= mixCell(index ^ ((uint64_t)previous << 48));
+    if (cost != 1)
+        m_costHash ^= mixCell(index ^ ((uint64_t)cost << 48));
+
+    m_costHistogram[previous]--;
+    m_costHistogram[cost]++;
+    m_costs[index] = cost;
+    m_revision++;
+    return true;
+}
+
+void Maze::randomizeCosts(uint8_t maxCost, uint32_t seed)
 {
-    for (const auto& row : m_grid)
+    std::mt19937 rng(seed == 0 ? std::random_device{}() : seed);
+    std::uniform_int_distribution<uint32_t> dist(1, maxCost == 0 ? 1 : maxCost);
+
+    for (uint32_t y = 0; y < m_height; y++)
     {
-        for (int cell : row)
+        for (uint32_t x = 0; x < m_width; x++)
         {
-            std::cout << (cell ? "█" : " ");
+            storeCost(x, y, dist(rng));
         }
-        std::cout << std::endl;
     }
+
+    // One notification for the whole layer rather than one per cell
+    notify(MazeChange{MazeChange::Type::Reset});
+}
+
+void Maze::clearCosts()
+{
+    if (dropCosts())
+        notify(MazeChange{MazeChange::Type::Reset});
+}
+
+bool Maze::dropCosts()
+{
+    if (m_costs.empty())
+        return false;
+
+    m_costs = std::vector<uint8_t>();
+    m_costHash = 0;
+    m_revision++;
+    return true;
+}
+
+const MazeTreeIndex& Maze::getTreeIndex() const
+{
+    if (!m_treeIndex.isBuilt())
+        m_treeIndex.build(*this);
+
+    return m_treeIndex;
+}
+
+uint64_t Maze::getHash() const
+{
+    return m_openCellsHash ^ m_costHash ^ dimensionHash(m_width, m_height);
+}
+
+uint64_t Maze::rowHash(const uint64_t* walls, uint32_t width, uint32_t y)
+{
+    uint64_t hash = 0;
+    for (uint32_t x = 0; x < width; x++)
+    {
+        if (!(walls[x >> 6] & (1ull << (x & 63))))
+            hash ^= mixCell((uint64_t)y * width + x);
+    }
+    return hash;
+}
+
+uint64_t Maze::dimensionHash(uint32_t width, uint32_t height)
+{
+    uint64_t dims = ((uint64_t)height << 32) | width;
+    return mixCell(dims ^ 0xffffffffffffffffull);
+}
+
+uint64_t Maze::getRevision() const
+{
+    return m_revision;
+}
+
+const std::string& Maze::getGeneratorName() const
+{
+    return m_generatorName;
+}
+
+uint32_t Maze::getSeed() const
+{
+    return m_seed;
+}
+
+void Maze::setWall(int cx, int cy, bool wall)
+{
+    if (isWall(cx, cy) == wall)
+        return;
+
+    // XOR of open cells, so toggling a cell updates the hash in O(1)
+    m_openCellsHash ^= mixCell((uint64_t)cy * m_width + cx);
+    m_cells[(size_t)(cy + 1) * m_rowWords + (cx >> 6)] ^= 1ull << (cx & 63);
+    if (m_layout == Layout::Tiled)
+        m_tileWords[(size_t)(cy >> 3) * m_tilesX + (cx >> 3)] ^= 1ull << (((cy & 7) << 3) | (cx & 7));
+}
+
+void Maze::print() const
+{
+    std::cout << std::flush;
+
+    BufferedWriter out(stdout);
+    MazeExporter::exportMaze(*this, {}, out, MazeExporter::Format::Ascii);
 }
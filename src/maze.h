@@ -1,9 +1,30 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#include "mazetreeindex.h"
+
 #include <stdint.h>
 #include <vector>
 #include <random>
+#include <string>
+#include <memory>
+#include <array>
+#include <functional>
+
+// What changed in a maze, passed to its change listeners
+struct MazeChange
+{
+    enum class Type
+    {
+        Wall,  // The cell at x, y was opened or closed
+        Cost,  // The cost of entering x, y changed
+        Reset  // Anything may have changed: generated, cleared, resized or
+               // the cost layer replaced
+    };
+
+    Type type;
+    int x = 0, y = 0;
+};
 
 class Maze
 {
@@ -12,29 +33,165 @@ public:
     inline static const int dx[] = { 0,  1,  0, -1 };
     inline static const int dy[] = { 1,  0, -1,  0 };
 
+    using ChangeListener = std::function<void(const MazeChange&)>;
+
+    enum class Layout
+    {
+        RowMajor, // isWall reads the row-major words
+        Tiled     // isWall reads a copy kept in 8x8 cell tiles
+    };
+
+    // Which cells are neighbours. Walls are stored the same for all of them.
+    enum class Topology
+    {
+        Square4, // dx/dy above
+        Square8, // Plus the diagonals, but no move cuts the corner of a wall
+        Hex      // Odd rows shifted half a cell east, six neighbours each
+    };
+
 public:
     Maze(uint32_t width = 21,
          uint32_t height = 21);
+    Maze(const Maze&) = delete;
+    Maze& operator=(const Maze&) = delete;
     virtual ~Maze() = default;
 
-    virtual void generate(uint32_t seed = 0);
+    void generate(uint32_t seed = 0);
     void clear();
     bool isValidCell(int cx, int cy) const;
     bool isWall(int cx, int cy) const;
+    // Bit i is set if the neighbour in direction i of dx/dy is open, cx, cy
+    // must be a valid cell. Owned storage has a row of wall words above and
+    // below the grid on top of the spare bit ending each row, so no read
+    // needs a bounds check. Read-only views have no such rows and check.
+    uint8_t getOpenSides(int cx, int cy) const;
+    // Views loaded from a file cannot be generated, cleared or resized
+    bool isReadOnly() const;
 
     void setSize(uint32_t width,
                  uint32_t height);
 
-    const std::vector<std::vector<int>>& getGrid() const;
+    // With the tiled layout a second copy of the wall bits is kept, one word
+    // per 8x8 block of cells, and isWall reads that one. A step up or down
+    // then stays in the same word for 7 of 8 rows instead of jumping a whole
+    // row ahead. getWords() stays row-major either way.
+    void setLayout(Layout layout);
+    Layout getLayout() const;
+
+    // The generators carve for Square4, and the other topologies read the
+    // same walls with more neighbours. Every topology keeps the four square
+    // moves, so a Square4 path stays valid in all of them. Changing it counts
+    // as a reset for listeners, as every solver result goes stale.
+    void setTopology(Topology topology);
+    Topology getTopology() const;
+
+    // Fraction of dead ends generate() opens up after carving, which adds
+    // loops to the perfect maze. Zero keeps it perfect, one leaves no dead
+    // ends. The same seed and ratio give the same maze.
+    void setBraidRatio(float ratio);
+    float getBraidRatio() const;
+
+    // Opens a wall cell or closes an open one. The tree index is dropped
+    // since a single edit can add a loop or split a tree, and is rebuilt on
+    // the next query. Returns false for read-only views and cells out of
+    // range.
+    bool toggleWall(int cx, int cy);
+
+    // Called after every edit, generate(), clear() and resize. Listeners must
+    // not add or remove listeners from the callback. Returns the id to
+    // remove the listener with.
+    uint32_t addChangeListener(ChangeListener listener);
+    void removeChangeListener(uint32_t id);
+
+    // Wall bits in row-major order, a set bit is a wall. Every row is padded
+    // to getRowWords() words with at least one spare wall bit at the end, so
+    // a horizontal step off either edge of a row always lands on a wall.
+    const uint64_t* getWords() const;
+    uint32_t getRowWords() const;
+    // The tiled copy, null with the row-major layout. Tile (x >> 3, y >> 3)
+    // holds cell x, y at bit (y & 7) * 8 + (x & 7), and like the words the
+    // tiles have a spare wall column and a wall row above and below.
+    const uint64_t* getTileWords() const;
+    uint32_t getTilesPerRow() const;
+
+    // Optional cost of entering each cell, 1 everywhere until a cost is set.
+    // The layer is dropped by clear(), so it has to be set after generate().
+    bool hasCosts() const;
+    uint8_t getCost(int cx, int cy) const;
+    // The cost layer in row-major order, null while every cost is 1
+    const uint8_t* getCosts() const;
+    uint8_t getMinCost() const;
+    uint8_t getMaxCost() const;
+    // Cells out of range are ignored
+    void setCost(int cx, int cy, uint8_t cost);
+    void randomizeCosts(uint8_t maxCost, uint32_t seed = 0);
+    void clearCosts();
+
+    // Built on the first call after a change rather than by generate(), as
+    // it takes several words per cell and only the tree solver reads it.
+    // Not safe to call from two threads at once.
+    const MazeTreeIndex& getTreeIndex() const;
+
+    // Content hash of the grid, kept up to date as cells are carved
+    uint64_t getHash() const;
+    // Bumped by generate(), clear(), setSize(), setTopology() and cost changes
+    uint64_t getRevision() const;
+
+    const std::string& getGeneratorName() const;
+    uint32_t getSeed() const;
 
     virtual void print() const;
     uint32_t getHeight() const;
     uint32_t getWidth() const;
 
 protected:
-    std::vector<std::vector<int>> m_grid;
+    // Carves the passages, called by generate() on a cleared and seeded grid
+    virtual void onGenerate() {}
+
+    void setWall(int cx, int cy, bool wall);
+
+private:
+    void clearCells();
+    void buildTiles();
+    void braid();
+    bool storeCost(int cx, int cy, uint8_t cost);
+    bool dropCosts();
+    void notify(const MazeChange& change) const;
+
+    // Parts of getHash(), for writers that never hold the whole maze
+    static uint64_t rowHash(const uint64_t* walls, uint32_t width, uint32_t y);
+    static uint64_t dimensionHash(uint32_t width, uint32_t height);
+
+protected:
     uint32_t m_width, m_height;
     std::mt19937 m_rng;
+    mutable MazeTreeIndex m_treeIndex; // Built by getTreeIndex()
+    std::string m_generatorName = "None";
+
+private:
+    std::vector<uint64_t> m_cells;          // Owned storage, with a wall row above and below
+    const uint64_t* m_words = nullptr;      // Row 0 of the owned storage or a mapped file
+    uint32_t m_rowWords = 0;
+    Layout m_layout = Layout::RowMajor;
+    Topology m_topology = Topology::Square4;
+    std::vector<uint64_t> m_tiles;          // Tiled layout only, row-major tiles and a wall row of tiles above and below
+    uint64_t* m_tileWords = nullptr;        // First row of tiles inside the grid
+    uint32_t m_tilesX = 0;                  // Tiles per row, one spare like the words
+    std::shared_ptr<const void> m_mapping;  // Keeps the file of a read-only view mapped
+    uint32_t m_seed = 0;
+    float m_braidRatio = 0.0f;
+    uint64_t m_openCellsHash = 0;
+    uint64_t m_costHash = 0;
+    uint64_t m_revision = 0;
+
+    std::vector<uint8_t> m_costs;               // Empty while every cost is 1
+    std::array<uint32_t, 256> m_costHistogram{}; // Cells per cost, for min and max
+
+    std::vector<std::pair<uint32_t, ChangeListener>> m_listeners;
+    uint32_t m_nextListenerId = 1;
+
+    friend class MazeFile;
+    friend class MazeFileWriter;
 };
 
 #endif // MAZE_H
@@ -0,0 +1,320 @@
+#include "mazeexporter.h"
+
+#include <algorithm>
+#include <iostream>
+
+static constexpr size_t s_idatSize = 1 << 20;
+static constexpr uint32_t s_maxStoredBlock = 65535;
+
+static std::array<uint32_t, 256> makeCrcTable()
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < 256; n++)
+    {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        }
+        table[n] = c;
+    }
+    return table;
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size)
+{
+    static const auto table = makeCrcTable();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void putBigEndian(uint8_t* out, uint32_t value)
+{
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+}
+
+MazeExporter::MazeExporter(BufferedWriter& out,
+                           Format format,
+                           const AsciiGlyphs& glyphs)
+    : m_out(out),
+      m_format(format),
+      m_glyphs(glyphs)
+{}
+
+void MazeExporter::begin(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+
+    switch (m_format)
+    {
+    case Format::Ascii:
+        break;
+
+    case Format::Pbm:
+    {
+        std::string header = "P4\n" + std::to_string(width) + " " +
+                             std::to_string(height) + "\n";
+        m_out.write(header.data(), header.size());
+        m_row.assign((width + 7) / 8, 0);
+        break;
+    }
+
+    case Format::Pgm:
+    {
+        std::string header = "P5\n" + std::to_string(width) + " " +
+                             std::to_string(height) + "\n255\n";
+        m_out.write(header.data(), header.size());
+        m_row.assign(width, 0);
+        break;
+    }
+
+    case Format::Png:
+    {
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        m_out.write(signature, sizeof(signature));
+
+        // 2-bit palette image: filter byte plus four cells per byte
+        uint8_t ihdr[13] = {};
+        putBigEndian(ihdr, width);
+        putBigEndian(ihdr + 4, height);
+        ihdr[8] = 2; // Bit depth
+        ihdr[9] = 3; // Palette colour type
+        writePngChunk("IHDR", ihdr, sizeof(ihdr));
+
+        // Same colours as the renderer: open, wall, path
+        static const uint8_t palette[9] = {   0,   0,   0,
+                                             77, 128, 179,
+                                            255, 255, 255 };
+        writePngChunk("PLTE", palette, sizeof(palette));
+
+        m_idat.clear();
+        m_idat.reserve(s_idatSize);
+        m_adlerA = 1;
+        m_adlerB = 0;
+
+        static const uint8_t zlibHeader[2] = { 0x78, 0x01 };
+        m_idat.insert(m_idat.end(), zlibHeader, zlibHeader + 2);
+
+        m_row.assign(1 + (width + 3) / 4, 0);
+        break;
+    }
+    }
+}
+
+void MazeExporter::writeRow(const uint64_t* walls,
+                            const uint32_t* pathXs,
+                            size_t pathCount)
+{
+    const uint32_t* pathX = pathXs;
+    const uint32_t* pathEnd = pathXs + pathCount;
+
+    switch (m_format)
+    {
+    case Format::Ascii:
+        for (uint32_t x = 0; x < m_width; x++)
+        {
+            switch (cellAt(walls, x, pathX, pathEnd))
+            {
+            case Open: m_out.write(m_glyphs.open); break;
+            case Wall: m_out.write(m_glyphs.wall); break;
+            case Path: m_out.write(m_glyphs.path); break;
+            }
+        }
+        m_out.put('\n');
+        break;
+
+    case Format::Pbm:
+        // Same bit order as the wall words, just reversed within each byte
+        for (uint32_t byte = 0; byte < m_row.size(); byte++)
+        {
+            uint8_t bits = walls[byte / 8] >> ((byte % 8) * 8);
+            uint8_t reversed = 0;
+            for (int b = 0; b < 8; b++)
+            {
+                reversed |= ((bits >> b) & 1) << (7 - b);
+            }
+            m_row[byte] = reversed;
+        }
+        if (m_width % 8 != 0)
+            m_row.back() &= 0xff << (8 - m_width % 8);
+        m_out.write(m_row.data(), m_row.size());
+        break;
+
+    case Format::Pgm:
+    {
+        static const uint8_t levels[3] = { 255, 0, 128 };
+        for (uint32_t x = 0; x < m_width; x++)
+        {
+            m_row[x] = levels[cellAt(walls, x, pathX, pathEnd)];
+        }
+        m_out.write(m_row.data(), m_row.size());
+        break;
+    }
+
+    case Format::Png:
+        std::fill(m_row.begin(), m_row.end(), 0);
+        for (uint32_t x = 0; x < m_width; x++)
+        {
+            uint8_t cell = cellAt(walls, x, pathX, pathEnd);
+            m_row[1 + x / 4] |= cell << (6 - (x % 4) * 2);
+        }
+        writePngData(m_row.data(), m_row.size());
+        break;
+    }
+}
+
+void MazeExporter::end()
+{
+    if (m_format == Format::Png)
+    {
+        // Final empty stored block, then the Adler-32 of everything stored
+        static const uint8_t lastBlock[5] = { 0x01, 0x00, 0x00, 0xff, 0xff };
+        m_idat.insert(m_idat.end(), lastBlock, lastBlock + 5);
+
+        uint8_t adler[4];
+        putBigEndian(adler, (m_adlerB << 16) | m_adlerA);
+        m_idat.insert(m_idat.end(), adler, adler + 4);
+
+        flushPngData();
+        writePngChunk("IEND", nullptr, 0);
+    }
+
+    m_out.flush();
+}
+
+void MazeExporter::exportMaze(const Maze& maze,
+                              const std::vector<Point>& path,
+                              BufferedWriter& out,
+                              Format format,
+                              const AsciiGlyphs& glyphs)
+{
+    // Path cells ordered by row then column, the only per-maze state kept
+    std::vector<uint64_t> cells;
+    cells.reserve(path.size());
+    for (const auto& p : path)
+    {
+        cells.push_back(((uint64_t)p.y << 32) | (uint32_t)p.x);
+    }
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+    std::vector<uint32_t> columns;
+
+    MazeExporter exporter(out, format, glyphs);
+    exporter.begin(maze.getWidth(), maze.getHeight());
+
+    size_t next = 0;
+    for (uint32_t y = 0; y < maze.getHeight(); y++)
+    {
+        columns.clear();
+        for (; next < cells.size() && (cells[next] >> 32) == y; next++)
+        {
+            columns.push_back((uint32_t)cells[next]);
+        }
+
+        exporter.writeRow(maze.getWords() + (size_t)y * maze.getRowWords(),
+                          columns.data(),
+                          columns.size());
+    }
+
+    exporter.end();
+}
+
+bool MazeExporter::exportMaze(const Maze& maze,
+                              const std::vector<Point>& path,
+                              const std::string& filePath,
+                              Format format)
+{
+    BufferedWriter out(filePath);
+    if (!out.isOpen())
+    {
+        std::cerr << "Unable to open file for export: " << filePath << std::endl;
+        return false;
+    }
+
+    exportMaze(maze, path, out, format);
+
+    if (!out.good())
+    {
+        std::cerr << "Failed to export maze: " << filePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+MazeExporter::Cell MazeExporter::cellAt(const uint64_t* walls,
+                                        uint32_t x,
+                                        const uint32_t*& pathX,
+                                        const uint32_t* pathEnd) const
+{
+    if (pathX != pathEnd && *pathX == x)
+    {
+        pathX++;
+        return Path;
+    }
+
+    return ((walls[x >> 6] >> (x & 63)) & 1) ? Wall : Open;
+}
+
+void MazeExporter::writePngChunk(const char type[4],
+                                 const uint8_t* data,
+                                 uint32_t size)
+{
+    uint8_t length[4];
+    putBigEndian(length, size);
+    m_out.write(length, 4);
+    m_out.write(type, 4);
+    if (size > 0)
+        m_out.write(data, size);
+
+    uint32_t crc = crc32(0, (const uint8_t*)type, 4);
+    crc = crc32(crc, data, size);
+    uint8_t crcBytes[4];
+    putBigEndian(crcBytes, crc);
+    m_out.write(crcBytes, 4);
+}
+
+void MazeExporter::writePngData(const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        m_adlerA = (m_adlerA + data[i]) % 65521;
+        m_adlerB = (m_adlerB + m_adlerA) % 65521;
+    }
+
+    // Non-final stored deflate blocks, at most 64 KiB each
+    while (size > 0)
+    {
+        uint16_t len = (uint16_t)std::min<size_t>(size, s_maxStoredBlock);
+        uint8_t header[5] = { 0x00,
+                              (uint8_t)len, (uint8_t)(len >> 8),
+                              (uint8_t)~len, (uint8_t)(~len >> 8) };
+        m_idat.insert(m_idat.end(), header, header + 5);
+        m_idat.insert(m_idat.end(), data, data + len);
+
+        data += len;
+        size -= len;
+
+        if (m_idat.size() >= s_idatSize)
+            flushPngData();
+    }
+}
+
+void MazeExporter::flushPngData()
+{
+    if (m_idat.empty())
+        return;
+
+    writePngChunk("IDAT", m_idat.data(), m_idat.size());
+    m_idat.clear();
+}
@@ -0,0 +1,83 @@
+#ifndef MAZEEXPORTER_H
+#define MAZEEXPORTER_H
+
+#include "pathfinder.h"
+#include "bufferedwriter.h"
+
+#include <array>
+#include <string>
+
+struct AsciiGlyphs
+{
+    const char* wall = "█";
+    const char* open = " ";
+    const char* path = "*";
+};
+
+// Writes a maze, optionally with a path drawn over it, one row at a time.
+// Only the current row is ever held in memory, so the cost of an export is
+// the size of the output plus the path, whatever the size of the maze.
+class MazeExporter
+{
+public:
+    enum class Format
+    {
+        Ascii,
+        Pbm, // Walls only, 1 bit per cell
+        Pgm, // Walls, open cells and path as grey levels
+        Png  // Palette image, stored without compression
+    };
+
+public:
+    MazeExporter(BufferedWriter& out,
+                 Format format,
+                 const AsciiGlyphs& glyphs = AsciiGlyphs());
+
+    void begin(uint32_t width, uint32_t height);
+    // walls holds the row in Maze word layout, pathXs the sorted columns of
+    // path cells on this row
+    void writeRow(const uint64_t* walls,
+                  const uint32_t* pathXs,
+                  size_t pathCount);
+    void end();
+
+    static void exportMaze(const Maze& maze,
+                           const std::vector<Point>& path,
+                           BufferedWriter& out,
+                           Format format,
+                           const AsciiGlyphs& glyphs = AsciiGlyphs());
+    static bool exportMaze(const Maze& maze,
+                           const std::vector<Point>& path,
+                           const std::string& filePath,
+                           Format format);
+
+private:
+    enum Cell : uint8_t
+    {
+        Open = 0,
+        Wall = 1,
+        Path = 2
+    };
+
+    Cell cellAt(const uint64_t* walls,
+                uint32_t x,
+                const uint32_t*& pathX,
+                const uint32_t* pathEnd) const;
+
+    void writePngChunk(const char type[4], const uint8_t* data, uint32_t size);
+    void writePngData(const uint8_t* data, size_t size);
+    void flushPngData();
+
+private:
+    BufferedWriter& m_out;
+    Format m_format;
+    AsciiGlyphs m_glyphs;
+    uint32_t m_width = 0, m_height = 0;
+    std::vector<uint8_t> m_row;
+
+    // PNG zlib stream state, split into IDAT chunks as it fills up
+    std::vector<uint8_t> m_idat;
+    uint32_t m_adlerA = 1, m_adlerB = 0;
+};
+
+#endif // MAZEEXPORTER_H
@@ -0,0 +1,267 @@
+#include "mazefile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAZEFILE_USE_MMAP 1
+#endif
+
+static const char s_magic[8] = { 'M', 'A', 'Z', 'E', 'B', 'I', 'N', '\0' };
+
+static_assert(sizeof(MazeFileHeader) == 64,
+              "Header must keep the wall words 64-bit aligned");
+
+static uint32_t byteSwap(uint32_t v)
+{
+    return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+}
+
+// Bits past the width are walls in every row, searches step onto them
+// without checking the width
+static bool hasPadding(const uint64_t* words, uint32_t width, uint32_t height, uint32_t rowWords)
+{
+    uint64_t padding = ~0ull << (width & 63);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        if ((words[(size_t)y * rowWords + rowWords - 1] & padding) != padding)
+            return false;
+    }
+    return true;
+}
+
+bool MazeFile::save(const Maze& maze, const std::string& path)
+{
+    size_t wordCount = (size_t)maze.getRowWords() * maze.getHeight();
+
+    MazeFileHeader header{};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = version;
+    header.width = maze.getWidth();
+    header.height = maze.getHeight();
+    header.rowWords = maze.getRowWords();
+    header.seed = maze.getSeed();
+    // The cost layer is not saved, so neither is its hash
+    header.contentHash = maze.m_openCellsHash ^
+                         Maze::dimensionHash(header.width, header.height);
+    header.checksum = checksum(maze.getWords(), wordCount);
+    std::strncpy(header.generator,
+                 maze.getGeneratorName().c_str(),
+                 sizeof(header.generator) - 1);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "Unable to open maze file for writing: " << path << std::endl;
+        return false;
+    }
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)maze.getWords(), wordCount * sizeof(uint64_t));
+
+    if (!file)
+    {
+        std::cerr << "Failed to write maze file: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<Maze> MazeFile::load(const std::string& path,
+                                     bool verifyChecksum)
+{
+    std::shared_ptr<const void> mapping;
+    size_t size = 0;
+
+#ifdef MAZEFILE_USE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Unable to open maze file: " << path << std::endl;
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(MazeFileHeader))
+    {
+        std::cerr << "Invalid maze file: " << path << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+
+    size = st.st_size;
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        std::cerr << "Unable to map maze file: " << path << std::endl;
+        return nullptr;
+    }
+
+    mapping = std::shared_ptr<const void>(data, [size](const void* p)
+    {
+        ::munmap(const_cast<void*>(p), size);
+    });
+#else
+    // Without mmap the file is read once into a buffer owned by the view
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        std::cerr << "Unable to open maze file: " << path << std::endl;
+        return nullptr;
+    }
+
+    size = file.tellg();
+    auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+    file.seekg(0);
+    file.read((char*)buffer->data(), size);
+    if (!file || size < sizeof(MazeFileHeader))
+    {
+        std::cerr << "Invalid maze file: " << path << std::endl;
+        return nullptr;
+    }
+
+    mapping = std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+
+    const auto* header = (const MazeFileHeader*)mapping.get();
+    const auto* words = (const uint64_t*)(header + 1);
+    size_t wordCount = (size_t)header->rowWords * header->height;
+
+    if (std::memcmp(header->magic, s_magic, sizeof(s_magic)) == 0 &&
+        header->version != version && byteSwap(header->version) == version)
+    {
+        std::cerr << "Maze file has the wrong byte order: " << path << std::endl;
+        return nullptr;
+    }
+
+    if (std::memcmp(header->magic, s_magic, sizeof(s_magic)) != 0 ||
+        header->version != version ||
+        header->width == 0 || header->height == 0 ||
+        header->rowWords != header->width / 64 + 1 ||
+        size < sizeof(MazeFileHeader) + wordCount * sizeof(uint64_t))
+    {
+        std::cerr << "Invalid maze file: " << path << std::endl;
+        return nullptr;
+    }
+
+    if (!hasPadding(words, header->width, header->height, header->rowWords))
+    {
+        std::cerr << "Maze file has open cells past the row width: " << path << std::endl;
+        return nullptr;
+    }
+
+    if (verifyChecksum && checksum(words, wordCount) != header->checksum)
+    {
+        std::cerr << "Maze file checksum mismatch: " << path << std::endl;
+        return nullptr;
+    }
+
+    auto maze = std::make_shared<Maze>(1, 1);
+    maze->m_width = header->width;
+    maze->m_height = header->height;
+    maze->m_rowWords = header->rowWords;
+    maze->m_cells = std::vector<uint64_t>();
+    maze->m_words = words;
+    maze->m_seed = header->seed;
+    maze->m_generatorName = std::string(header->generator,
+                                        strnlen(header->generator,
+                                                sizeof(header->generator)));
+    maze->m_openCellsHash = header->contentHash ^
+                            Maze::dimensionHash(header->width, header->height);
+    maze->m_revision++;
+    maze->m_mapping = mapping;
+
+    return maze;
+}
+
+static const uint64_t s_checksumSeed = 0xcbf29ce484222325ull;
+
+static uint64_t continueChecksum(uint64_t hash, const uint64_t* words, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        hash = (hash ^ words[i]) * 0x100000001b3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+uint64_t MazeFile::checksum(const uint64_t* words, size_t count)
+{
+    return continueChecksum(s_checksumSeed, words, count);
+}
+
+bool MazeFileWriter::begin(const std::string& path,
+                           uint32_t width,
+                           uint32_t height,
+                           uint32_t seed,
+                           const std::string& generator)
+{
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        std::cerr << "Unable to open maze file for writing: " << path << std::endl;
+        return false;
+    }
+
+    m_path = path;
+    m_header = MazeFileHeader{};
+    std::memcpy(m_header.magic, s_magic, sizeof(s_magic));
+    m_header.version = MazeFile::version;
+    m_header.width = width;
+    m_header.height = height;
+    m_header.rowWords = width / 64 + 1;
+    m_header.seed = seed;
+    std::strncpy(m_header.generator,
+                 generator.c_str(),
+                 sizeof(m_header.generator) - 1);
+
+    m_row = 0;
+    m_openCellsHash = 0;
+    m_checksum = s_checksumSeed;
+
+    // Placeholder until the hashes are known
+    m_file.write((const char*)&m_header, sizeof(m_header));
+    return true;
+}
+
+void MazeFileWriter::writeRow(const uint64_t* walls)
+{
+    m_openCellsHash ^= Maze::rowHash(walls, m_header.width, m_row++);
+    m_checksum = continueChecksum(m_checksum, walls, m_header.rowWords);
+    m_file.write((const char*)walls, m_header.rowWords * sizeof(uint64_t));
+}
+
+bool MazeFileWriter::end()
+{
+    if (m_row != m_header.height)
+    {
+        std::cerr << "Maze file ended after " << m_row << " of "
+                  << m_header.height << " rows: " << m_path << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    m_header.contentHash = m_openCellsHash ^
+                           Maze::dimensionHash(m_header.width, m_header.height);
+    m_header.checksum = m_checksum;
+    m_file.seekp(0);
+    m_file.write((const char*)&m_header, sizeof(m_header));
+    m_file.close();
+
+    if (!m_file)
+    {
+        std::cerr << "Failed to write maze file: " << m_path << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,70 @@
+#ifndef MAZEFILE_H
+#define MAZEFILE_H
+
+#include "maze.h"
+
+#include <fstream>
+#include <string>
+#include <memory>
+
+// Fixed 64 byte header of a binary maze file. It is followed by the wall
+// bits exactly as Maze stores them, getRowWords() 64-bit words per row, so
+// a file can be mapped and used without copying. Header and
+// words are in the byte order of the machine that saved them, and load()
+// rejects a file saved with the other one.
+struct MazeFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowWords;
+    uint32_t seed;
+    uint32_t reserved;
+    uint64_t contentHash; // Maze::getHash() of the walls, costs are not saved
+    uint64_t checksum;    // Over the wall words
+    char generator[16];
+};
+
+class MazeFile
+{
+public:
+    static constexpr uint32_t version = 1;
+
+public:
+    static bool save(const Maze& maze, const std::string& path);
+
+    // Maps the file and returns a read-only view of it, nullptr on failure.
+    // Opening reads the last word of every row, as the solvers rely on the
+    // spare wall bits after each row, and every word only when
+    // verifyChecksum is set.
+    static std::shared_ptr<Maze> load(const std::string& path,
+                                      bool verifyChecksum = false);
+
+    static uint64_t checksum(const uint64_t* words, size_t count);
+};
+
+// Writes a maze file one row at a time, for mazes generated straight to disk
+// that are never held in memory. The header is filled in by end().
+class MazeFileWriter
+{
+public:
+    bool begin(const std::string& path,
+               uint32_t width,
+               uint32_t height,
+               uint32_t seed,
+               const std::string& generator);
+    // walls holds the row in Maze word layout, width / 64 + 1 words
+    void writeRow(const uint64_t* walls);
+    bool end();
+
+private:
+    std::ofstream m_file;
+    std::string m_path;
+    MazeFileHeader m_header{};
+    uint32_t m_row = 0;
+    uint64_t m_openCellsHash = 0;
+    uint64_t m_checksum = 0;
+};
+
+#endif // MAZEFILE_H
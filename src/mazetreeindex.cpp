@@ -0,0 +1,244 @@
+#include "mazetreeindex.h"
+#include "maze.h"
+
+#include <algorithm>
+
+void MazeTreeIndex::build(const Maze& maze)
+{
+    reset();
+
+    m_width = maze.getWidth();
+    m_height = maze.getHeight();
+    m_isTree = true;
+
+    size_t cellCount = (size_t)m_width * m_height;
+    m_parent.assign(cellCount, invalid);
+    m_first.assign(cellCount, invalid);
+    m_component.assign(cellCount, invalid);
+    uint32_t component = 0;
+
+    // Iterative DFS, every stack entry is a cell and the next direction to try
+    std::vector<std::pair<uint32_t, uint8_t>>& stack = m_stack;
+
+    for (uint32_t root = 0; root < cellCount; root++)
+    {
+        if (m_first[root] != invalid ||
+            maze.isWall(root % m_width, root / m_width))
+            continue;
+
+        m_component[root] = component;
+        m_first[root] = m_euler.size();
+        m_euler.push_back(root);
+        m_eulerDepth.push_back(0);
+        stack.push_back({root, 0});
+
+        while (!stack.empty())
+        {
+            uint32_t cell = stack.back().first;
+            uint8_t dir = stack.back().second;
+
+            if (dir == 4)
+            {
+                // Returning to the parent closes this subtree in the tour
+                stack.pop_back();
+                if (!stack.empty())
+                {
+                    m_euler.push_back(stack.back().first);
+                    m_eulerDepth.push_back(stack.size() - 1);
+                }
+                continue;
+            }
+
+            stack.back().second++;
+
+            int nx = (int)(cell % m_width) + Maze::dx[dir];
+            int ny = (int)(cell / m_width) + Maze::dy[dir];
+            if (!maze.isValidCell(nx, ny) || maze.isWall(nx, ny))
+                continue;
+
+            uint32_t next = cellIndex(nx, ny);
+            if (next == m_parent[cell])
+                continue;
+
+            if (m_first[next] != invalid)
+            {
+                // Reached an already visited cell through a second route
+                m_isTree = false;
+                continue;
+            }
+
+            m_parent[next] = cell;
+            m_component[next] = component;
+            m_first[next] = m_euler.size();
+            m_euler.push_back(next);
+            m_eulerDepth.push_back(stack.size());
+            stack.push_back({next, 0});
+        }
+
+        component++;
+    }
+
+    // Sparse table over block minima of the tour
+    uint32_t blocks = (m_euler.size() + s_blockSize - 1) / s_blockSize;
+
+    m_log2.assign(blocks + 1, 0);
+    for (uint32_t i = 2; i <= blocks; i++)
+    {
+        m_log2[i] = m_log2[i / 2] + 1;
+    }
+
+    // Resized rather than rebuilt, so a regenerated maze of the same size
+    // fills the levels of the last one
+    m_sparse.resize(blocks > 0 ? m_log2[blocks] + 1 : 0);
+
+    if (blocks > 0)
+    {
+        m_sparse[0].resize(blocks);
+        for (uint32_t b = 0; b < blocks; b++)
+        {
+            uint32_t lo = b * s_blockSize;
+            uint32_t hi = std::min<uint32_t>(lo + s_blockSize, m_euler.size()) - 1;
+            m_sparse[0][b] = scanMin(lo, hi);
+        }
+    }
+
+    for (uint32_t k = 1; (1u << k) <= blocks; k++)
+    {
+        const auto& prev = m_sparse[k - 1];
+        auto& level = m_sparse[k];
+        level.resize(blocks - (1u << k) + 1);
+        for (uint32_t b = 0; b < level.size(); b++)
+        {
+            level[b] = shallower(prev[b], prev[b + (1u << (k - 1))]);
+        }
+    }
+
+    m_built = true;
+}
+
+void MazeTreeIndex::reset()
+{
+    m_width = m_height = 0;
+    m_built = false;
+    m_isTree = false;
+    m_parent.clear();
+    m_first.clear();
+    m_euler.clear();
+    m_eulerDepth.clear();
+    m_component.clear();
+    for (auto& level : m_sparse)
+    {
+        level.clear();
+    }
+    m_log2.clear();
+}
+
+bool MazeTreeIndex::isBuilt() const
+{
+    return m_built;
+}
+
+bool MazeTreeIndex::isTree() const
+{
+    return m_isTree;
+}
+
+uint32_t MazeTreeIndex::cellIndex(int cx, int cy) const
+{
+    return (uint32_t)cy * m_width + (uint32_t)cx;
+}
+
+bool MazeTreeIndex::connected(uint32_t a, uint32_t b) const
+{
+    if (!m_built || m_first[a] == invalid || m_first[b] == invalid)
+        return false;
+
+    return m_component[a] == m_component[b];
+}
+
+uint32_t MazeTreeIndex::lca(uint32_t a, uint32_t b) const
+{
+    if (!connected(a, b))
+        return invalid;
+
+    uint32_t lo = std::min(m_first[a], m_first[b]);
+    uint32_t hi = std::max(m_first[a], m_first[b]);
+    return m_euler[minByDepth(lo, hi)];
+}
+
+uint32_t MazeTreeIndex::distance(uint32_t a, uint32_t b) const
+{
+    uint32_t ancestor = lca(a, b);
+    if (ancestor == invalid)
+        return invalid;
+
+    return m_eulerDepth[m_first[a]] +
+           m_eulerDepth[m_first[b]] -
+           2 * m_eulerDepth[m_first[ancestor]];
+}
+
+std::vector<uint32_t> MazeTreeIndex::path(uint32_t a, uint32_t b) const
+{
+    uint32_t ancestor = lca(a, b);
+    if (ancestor == invalid)
+        return {};
+
+    std::vector<uint32_t> path;
+    path.reserve(distance(a, b) + 1);
+
+    for (uint32_t cell = a; cell != ancestor; cell = m_parent[cell])
+    {
+        path.push_back(cell);
+    }
+    path.push_back(ancestor);
+
+    // The second half is collected upwards from b, then flipped into place
+    size_t mid = path.size();
+    for (uint32_t cell = b; cell != ancestor; cell = m_parent[cell])
+    {
+        path.push_back(cell);
+    }
+    std::reverse(path.begin() + mid, path.end());
+
+    return path;
+}
+
+uint32_t MazeTreeIndex::shallower(uint32_t a, uint32_t b) const
+{
+    return m_eulerDepth[b] < m_eulerDepth[a] ? b : a;
+}
+
+uint32_t MazeTreeIndex::minByDepth(uint32_t lo, uint32_t hi) const
+{
+    uint32_t bl = lo / s_blockSize;
+    uint32_t bh = hi / s_blockSize;
+
+    if (bl == bh)
+        return scanMin(lo, hi);
+
+    // Partial blocks at both ends, full blocks in between from the table
+    uint32_t best = shallower(scanMin(lo, (bl + 1) * s_blockSize - 1),
+                              scanMin(bh * s_blockSize, hi));
+
+    if (bl + 1 < bh)
+    {
+        uint32_t first = bl + 1;
+        uint32_t last = bh - 1;
+        uint8_t k = m_log2[last - first + 1];
+        best = shallower(best, m_sparse[k][first]);
+        best = shallower(best, m_sparse[k][last - (1u << k) + 1]);
+    }
+
+    return best;
+}
+
+uint32_t MazeTreeIndex::scanMin(uint32_t lo, uint32_t hi) const
+{
+    uint32_t best = lo;
+    for (uint32_t i = lo + 1; i <= hi; i++)
+    {
+        if (m_eulerDepth[i] < m_eulerDepth[best])
+            best = i;
+    }
+    return best;
+}
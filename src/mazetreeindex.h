@@ -0,0 +1,60 @@
+#ifndef MAZETREEINDEX_H
+#define MAZETREEINDEX_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+class Maze;
+
+// Lowest common ancestor index over the open cells of a maze.
+// The generators carve spanning trees, so the path between two cells is
+// unique. The index roots every tree of the forest, records its Euler tour and
+// keeps a sparse table over fixed-size blocks of the tour, and every cell the
+// tree it is in. A connected, lca or distance query is then a constant
+// amount of work and a path query walks only the path itself.
+class MazeTreeIndex
+{
+public:
+    static constexpr uint32_t invalid = UINT32_MAX;
+
+public:
+    MazeTreeIndex() = default;
+
+    // Rebuilding reuses the memory of the last index, and reset() keeps it
+    void build(const Maze& maze);
+    void reset();
+
+    bool isBuilt() const;
+    // False if the grid contains a loop, in which case paths are not unique
+    bool isTree() const;
+
+    uint32_t cellIndex(int cx, int cy) const;
+    bool connected(uint32_t a, uint32_t b) const;
+    uint32_t lca(uint32_t a, uint32_t b) const;
+    uint32_t distance(uint32_t a, uint32_t b) const;
+    std::vector<uint32_t> path(uint32_t a, uint32_t b) const;
+
+private:
+    uint32_t shallower(uint32_t a, uint32_t b) const;
+    uint32_t minByDepth(uint32_t lo, uint32_t hi) const;
+    uint32_t scanMin(uint32_t lo, uint32_t hi) const;
+
+private:
+    static constexpr uint32_t s_blockSize = 32;
+
+    uint32_t m_width = 0, m_height = 0;
+    bool m_built = false;
+    bool m_isTree = false;
+
+    std::vector<uint32_t> m_parent;         // Per cell, invalid for roots and walls
+    std::vector<uint32_t> m_first;          // Per cell, first position in the Euler tour
+    std::vector<uint32_t> m_euler;          // Cells in Euler tour order
+    std::vector<uint32_t> m_eulerDepth;     // Depth of each tour entry
+    std::vector<uint32_t> m_component;      // Per cell, the tree it is in
+    std::vector<std::vector<uint32_t>> m_sparse; // Tour position of the shallowest entry per block range
+    std::vector<uint8_t> m_log2;
+    std::vector<std::pair<uint32_t, uint8_t>> m_stack; // DFS of build()
+};
+
+#endif // MAZETREEINDEX_H
@@ -3,29 +3,64 @@
 #include "recursivebacktrackingmaze.h"
 #include "kruskalmaze.h"
 #include "primmaze.h"
+#include "ellermaze.h"
+#include "sidewindermaze.h"
+#include "binarytreemaze.h"
+#include "wilsonmaze.h"
+#include "mazefile.h"
 
 #include "bfspathfinder.h"
 #include "dfspathfinder.h"
 #include "astarpathfinder.h"
+#include "treepathfinder.h"
+#include "bitbfspathfinder.h"
+#include "dijkstrapathfinder.h"
+#include "parallelbfspathfinder.h"
+#include "lpastarpathfinder.h"
+#include "hpastarpathfinder.h"
+#include "cachedpathfinder.h"
 
 #include <imgui.h>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <bitset>
+
+static uint64_t countOpenCells(const Maze& maze)
+{
+    size_t wordCount = (size_t)maze.getRowWords() * maze.getHeight();
+    uint64_t walls = 0;
+    for (size_t i = 0; i < wordCount; i++)
+    {
+        walls += std::bitset<64>(maze.getWords()[i]).count();
+    }
+    return wordCount * 64 - walls;
+}
 
 MazeVisualizerApp::MazeVisualizerApp()
 {
     m_startPointColor = glm::vec3(0.7f, 0.5f, 0.3f);
     m_endPointColor = glm::vec3(0.5f, 0.3f, 0.5f);
 
-    m_mazes[0] = std::make_shared<RecursiveBacktrackingMaze>(51, 51);
-    m_mazes[1] = std::make_shared<KruskalMaze>(51, 51);
-    m_mazes[2] = std::make_shared<PrimMaze>(51, 51);
+    for (int algo = 0; algo < (int)m_mazes.size(); algo++)
+    {
+        m_mazes[algo] = createMaze(algo, 51, 51);
+        m_backMazes[algo] = createMaze(algo, 51, 51);
+    }
 
-    m_pathFinders[0] = std::make_shared<BFSPathFinder>();
-    m_pathFinders[1] = std::make_shared<DFSPathFinder>();
-    m_pathFinders[2] = std::make_shared<AStarPathFinder>();
+    m_pathCache = std::make_shared<PathCache>(128);
+    m_pathFinders[0] = std::make_shared<CachedPathFinder>(std::make_shared<BFSPathFinder>(), m_pathCache);
+    m_pathFinders[1] = std::make_shared<CachedPathFinder>(std::make_shared<DFSPathFinder>(), m_pathCache);
+    m_pathFinders[2] = std::make_shared<CachedPathFinder>(std::make_shared<AStarPathFinder>(), m_pathCache);
+    m_pathFinders[3] = std::make_shared<CachedPathFinder>(std::make_shared<TreePathFinder>(), m_pathCache);
+    m_pathFinders[4] = std::make_shared<CachedPathFinder>(std::make_shared<BitBFSPathFinder>(), m_pathCache);
+    m_pathFinders[5] = std::make_shared<CachedPathFinder>(std::make_shared<DijkstraPathFinder>(), m_pathCache);
+    m_parallelBFS = std::make_shared<ParallelBFSPathFinder>();
+    m_pathFinders[6] = std::make_shared<CachedPathFinder>(m_parallelBFS, m_pathCache);
+    m_pathFinders[7] = std::make_shared<CachedPathFinder>(std::make_shared<LPAStarPathFinder>(), m_pathCache);
+    m_pathFinders[8] = std::make_shared<CachedPathFinder>(std::make_shared<HPAStarPathFinder>(16), m_pathCache);
     m_finder = m_pathFinders[0];
 
     m_maze = m_mazes[0];
@@ -44,51 +79,41 @@ void MazeVisualizerApp::onCreate()
 
 void MazeVisualizerApp::onUpdate()
 {
+    // Results of background jobs only land here, between two frames
+    m_worker.poll();
+
     m_renderer.drawMaze(*m_maze);
     if (m_showFinalPath)
         m_renderer.drawPath(m_path, *m_finder);
 
-    const auto& grid = m_maze->getGrid();
-    auto rows = grid.size();
-    auto cells = grid[0].size();
-
-    // Calculate quad size based on window dimensions
-    float quadWidth = 2.0f / rows;
-    float quadHeight = 2.0f / cells;
+    glm::vec2 size = Renderer::cellSize(*m_maze);
 
     for (uint8_t i = 0; i < 2; i++)
     {
         auto point = i == 0 ? m_start : m_end;
         auto color = i == 0 ? m_startPointColor : m_endPointColor;
-        float xPos = -1.0f + point.x * quadWidth + quadWidth / 2.0f;
-        float yPos = -1.0f + point.y * quadHeight + quadHeight / 2.0f;
-        m_renderer.drawQuad({xPos, yPos, 0.0},
-                            {quadWidth * 0.6f, quadHeight * 0.6f, 0.0f},
+        m_renderer.drawQuad(glm::vec3(Renderer::cellCenter(*m_maze, point), 0.0f),
+                            glm::vec3(size * 0.6f, 0.0f),
                             color);
     }
 
-    if (!m_iteration.empty() && m_visualize)
+    if (m_stepper)
     {
-        auto& iterData = m_iteration[m_iterIndex];
-        auto point = iterData.currentPoint;
-
-        float xCurrPos = -1.0f + point.x * quadWidth + quadWidth / 2.0f;
-        float yCurrPos = -1.0f + point.y * quadHeight + quadHeight / 2.0f;
-        m_renderer.drawQuad({xCurrPos, yCurrPos, 0.0},
-                            {quadWidth, quadHeight, 0.0f},
-                            glm::vec3(0.5f, 0.2f, 0.3f));
-
-        m_renderer.drawPath(iterData.path, *m_finder);
-
-        for (auto& [n, fScore] : iterData.neighbors)
+        // Live search, advanced by a fixed number of expansions per frame
+        if (m_stepper->step(m_stepsPerFrame))
+        {
+            drawIteration(m_stepper->getLastStep());
+        }
+        else
         {
-            float xPos = -1.0f + n.x * quadWidth + quadWidth / 2.0f;
-            float yPos = -1.0f + n.y * quadHeight + quadHeight / 2.0f;
-            m_renderer.drawQuad({xPos, yPos, 0.0},
-                                {quadWidth, quadHeight, 0.0f},
-                                glm::vec3(0.2f, 0.5f, 0.3f));
+            m_path = m_stepper->getStepResult();
+            m_stepper.reset();
         }
     }
+    else if (!m_iteration.empty() && m_visualize)
+    {
+        drawIteration(m_iteration[m_iterIndex]);
+    }
 
     // renderer.drawQuad(glm::vec3(0.2f, 0.2f, 0.0f), glm::vec3(0.5f, 0.8f, 0.3f)); // greeb quad
     // renderer.drawQuad(glm::vec3(0.3f, 0.3f, 0.0f), glm::vec3(0.3f, 0.5f, 0.8f)); // blue quad
@@ -108,22 +133,50 @@ void MazeVisualizerApp::onUpdate()
     }
 }
 
+void MazeVisualizerApp::drawIteration(const IterationData& iterData)
+{
+    glm::vec2 size = Renderer::cellSize(*m_maze);
+
+    m_renderer.drawQuad(glm::vec3(Renderer::cellCenter(*m_maze, iterData.currentPoint), 0.0f),
+                        glm::vec3(size, 0.0f),
+                        glm::vec3(0.5f, 0.2f, 0.3f));
+
+    m_renderer.drawPath(iterData.path, *m_finder);
+
+    for (auto& [n, fScore] : iterData.neighbors)
+    {
+        m_renderer.drawQuad(glm::vec3(Renderer::cellCenter(*m_maze, n), 0.0f),
+                            glm::vec3(size, 0.0f),
+                            glm::vec3(0.2f, 0.5f, 0.3f));
+    }
+}
+
 void MazeVisualizerApp::onImGuiUpdate()
 {
+    // The maze and the solvers belong to the running search or job
+    bool busy = isBusy();
+
     ImGui::Begin("Maze");
+    if (busy)
+        drawWorkerStatus();
+    ImGui::BeginDisabled(busy);
     static const char* mazeAlgos[] =
     {   "Recursive Backtracking",
         "Kruskal’s algorithm",
-        "Prim’s algorithm"
+        "Prim’s algorithm",
+        "Eller’s algorithm",
+        "Sidewinder",
+        "Binary Tree",
+        "Wilson’s algorithm (uniform)"
     };
-    static int currentAlgo = 0;
-    if (ImGui::Combo("Algo", &currentAlgo, mazeAlgos, IM_ARRAYSIZE(mazeAlgos)))
+    if (ImGui::Combo("Algo", &m_mazeAlgo, mazeAlgos, IM_ARRAYSIZE(mazeAlgos)))
     {
-        std::cout << "Selected: " << mazeAlgos[currentAlgo] << std::endl;
+        std::cout << "Selected: " << mazeAlgos[m_mazeAlgo] << std::endl;
         auto prevSelectedMaze = m_maze;
-        m_maze = m_mazes[currentAlgo];
+        m_maze = m_mazes[m_mazeAlgo];
         m_maze->setSize(prevSelectedMaze->getWidth(),
                         prevSelectedMaze->getHeight());
+        m_maze->setTopology((Maze::Topology)m_topology);
         m_finder->setMaze(m_maze);
         onClear();
     }
@@ -175,9 +228,47 @@ void MazeVisualizerApp::onImGuiUpdate()
         }
     }
 
+    ImGui::SliderFloat("Braid", &m_braidRatio, 0.0f, 1.0f, "%.2f of dead ends");
+    if (ImGui::Checkbox("Tiled storage", &m_tiledLayout))
+        m_maze->setLayout(m_tiledLayout ? Maze::Layout::Tiled : Maze::Layout::RowMajor);
+    static const char* topologies[] = { "Square", "Square + diagonals", "Hex" };
+    if (ImGui::Combo("Topology", &m_topology, topologies, IM_ARRAYSIZE(topologies)))
+    {
+        m_maze->setTopology((Maze::Topology)m_topology);
+        m_path.clear();
+        m_iteration.clear();
+    }
     if (ImGui::Button("Randomize"))
         onRandomize();
+    ImGui::SameLine();
+    if (ImGui::Button("Random costs"))
+    {
+        m_maze->randomizeCosts(9, time(nullptr));
+        m_path.clear();
+        m_iteration.clear();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear costs"))
+    {
+        m_maze->clearCosts();
+        m_path.clear();
+        m_iteration.clear();
+    }
+
+    ImGui::InputInt2("Wall", &m_wallCell.x);
+    ImGui::SameLine();
+    if (ImGui::Button("Toggle"))
+        onToggleWall();
+
+    static char mazeFilePath[256] = "maze.bin";
+    ImGui::InputText("File", mazeFilePath, IM_ARRAYSIZE(mazeFilePath));
+    if (ImGui::Button("Save"))
+        MazeFile::save(*m_maze, mazeFilePath);
+    ImGui::SameLine();
+    if (ImGui::Button("Load"))
+        onLoad(mazeFilePath);
 
+    ImGui::EndDisabled();
     ImGui::End();
 
     ImGui::Begin("Path Finder");
@@ -185,9 +276,16 @@ void MazeVisualizerApp::onImGuiUpdate()
     {
         "Breadth-First Search (BFS)",
         "Depth-First Search (DFS)",
-        "A*"
+        "A*",
+        "Tree index (LCA)",
+        "Bit-parallel BFS",
+        "Dijkstra",
+        "Parallel BFS",
+        "LPA* (incremental)",
+        "HPA* (hierarchical)"
     };
     static int currentPathFinderAlgo = 2;
+    ImGui::BeginDisabled(busy);
     if (ImGui::Combo("Algo", &currentPathFinderAlgo, pathFinderAlgos, IM_ARRAYSIZE(pathFinderAlgos)))
     {
         std::cout << "Selected: " << pathFinderAlgos[currentPathFinderAlgo] << std::endl;
@@ -196,22 +294,66 @@ void MazeVisualizerApp::onImGuiUpdate()
         m_path.clear();
         m_iteration.clear();
     }
-    ImGui::InputInt2("Start Pos", &m_start.x);
+    ImGui::EndDisabled();
+    if (!m_finder->supportsTopology(m_maze->getTopology()))
+        ImGui::TextDisabled("Square moves only, may miss the path or a shorter one");
+
+    // Moving an endpoint makes a running solve pointless
+    if (ImGui::InputInt2("Start Pos", &m_start.x) && busy)
+        m_cancel.cancel();
     ImGui::SameLine();
     ImGui::ColorEdit4("Start Point Color",
                       &m_startPointColor.x,
                       ImGuiColorEditFlags_NoInputs |
                           ImGuiColorEditFlags_NoLabel);
-    ImGui::InputInt2("End Pos", &m_end.x);
+    if (ImGui::InputInt2("End Pos", &m_end.x) && busy)
+        m_cancel.cancel();
     ImGui::SameLine();
     ImGui::ColorEdit4("End Point Color",
                       &m_endPointColor.x,
                       ImGuiColorEditFlags_NoInputs |
                           ImGuiColorEditFlags_NoLabel);
+    ImGui::BeginDisabled(busy);
     if (ImGui::Button("Find"))
         onFind();
+    ImGui::EndDisabled();
     ImGui::SameLine();
     ImGui::Checkbox("Show final path", &m_showFinalPath);
+    ImGui::Checkbox("Live search", &m_liveSearch);
+    if (m_liveSearch)
+        ImGui::SliderInt("Steps per frame", &m_stepsPerFrame, 1, 10000);
+    ImGui::InputInt("Time budget (ms)", &m_timeBudgetMs);
+    ImGui::InputInt("Expansion budget", &m_expansionBudget);
+    m_timeBudgetMs = std::max(m_timeBudgetMs, 0);
+    m_expansionBudget = std::max(m_expansionBudget, 0);
+
+    if (busy)
+    {
+        drawWorkerStatus();
+    }
+    else
+    {
+        ImGui::Text("Last search: %s", searchStatusName(m_finder->getLastStatus()));
+        ImGui::Text("Cache: %llu hits, %llu misses",
+                    (unsigned long long)m_pathCache->getHits(),
+                    (unsigned long long)m_pathCache->getMisses());
+    }
+
+    if (!busy && m_finder == m_pathFinders[6] && !m_parallelBFS->getLevelStats().empty())
+    {
+        const auto& levels = m_parallelBFS->getLevelStats();
+        double total = 0.0, slowest = 0.0;
+        size_t bottomUp = 0;
+        for (const auto& level : levels)
+        {
+            total += level.milliseconds;
+            slowest = std::max(slowest, level.milliseconds);
+            bottomUp += level.bottomUp;
+        }
+        ImGui::Text("%u threads, %zu levels (%zu bottom-up)",
+                    m_parallelBFS->getThreadCount(), levels.size(), bottomUp);
+        ImGui::Text("%.2f ms total, slowest level %.3f ms", total, slowest);
+    }
 
     if (!m_iteration.empty())
     {
@@ -272,22 +414,171 @@ void MazeVisualizerApp::onImGuiUpdate()
 
 void MazeVisualizerApp::onDestroy()
 {
-
+    // The worker is joined on destruction, don't leave it a long solve
+    m_cancel.cancel();
 }
 
 void MazeVisualizerApp::onRandomize()
 {
-    m_maze->generate(time(nullptr));
+    if (isBusy())
+        return;
+
+    // The new maze is generated into the back buffer of the selected
+    // generator while the front one stays on screen, and the two swap once
+    // it is done. Both are kept, so each run reuses the walls, generator
+    // and tree index buffers of the one before. This also leaves a loaded
+    // read-only view for the selected generator.
+    int algo = m_mazeAlgo;
+    auto maze = m_backMazes[algo];
+    if (maze->getWidth() != m_maze->getWidth() || maze->getHeight() != m_maze->getHeight())
+        maze->setSize(m_maze->getWidth(), m_maze->getHeight());
+    maze->setBraidRatio(m_braidRatio);
+    maze->setLayout(m_tiledLayout ? Maze::Layout::Tiled : Maze::Layout::RowMajor);
+    maze->setTopology((Maze::Topology)m_topology);
+    uint32_t seed = time(nullptr);
+
+    m_cancel.reset();
+    m_job = Job::Generate;
+    m_worker.submit([this, algo, maze, seed]() -> BackgroundWorker::Publish
+    {
+        maze->generate(seed);
+
+        return [this, algo]()
+        {
+            // Generators can't be interrupted, so a cancel drops the result
+            if (m_cancel.isCancelled())
+                return;
+
+            std::swap(m_mazes[algo], m_backMazes[algo]);
+            m_maze = m_mazes[algo];
+            m_finder->setMaze(m_maze);
+            m_path.clear();
+            m_iteration.clear();
+        };
+    });
+}
+
+void MazeVisualizerApp::onLoad(const std::string& path)
+{
+    auto maze = MazeFile::load(path);
+    if (!maze)
+        return;
+
+    maze->setTopology((Maze::Topology)m_topology);
+    m_maze = maze;
+    m_finder->setMaze(m_maze);
     m_path.clear();
     m_iteration.clear();
 }
 
 void MazeVisualizerApp::onFind()
 {
-    auto [path, iterData] = m_finder->findPath(m_start, m_end);
-    m_path = path;
-    m_iteration = iterData;
-    m_iterIndex = 0;
+    if (isBusy())
+        return;
+
+    SearchLimits limits;
+    limits.token = m_cancel;
+    limits.progress = m_progress;
+    if (m_timeBudgetMs > 0)
+    {
+        limits.deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(m_timeBudgetMs);
+    }
+    limits.maxExpansions = m_expansionBudget;
+    m_cancel.reset();
+
+    // Resumable solvers can run live on this thread a few steps per frame.
+    // The cache only stores finished results, so step the solver behind it.
+    auto cached = std::dynamic_pointer_cast<CachedPathFinder>(m_finder);
+    auto stepper = cached ? cached->getFinder() : m_finder;
+    if (m_liveSearch && stepper->isResumable())
+    {
+        stepper->setMaze(m_maze);
+        stepper->setSearchLimits(limits);
+        stepper->begin(m_start, m_end);
+        m_stepper = stepper;
+        m_path.clear();
+        m_iteration.clear();
+        return;
+    }
+
+    m_finder->setSearchLimits(limits);
+    m_job = Job::Solve;
+    m_progressTotal = countOpenCells(*m_maze);
+
+    auto finder = m_finder;
+    Point start = m_start, end = m_end;
+    m_worker.submit([this, finder, start, end]() -> BackgroundWorker::Publish
+    {
+        auto result = std::make_shared<std::pair<std::vector<Point>,
+                                                 std::vector<IterationData>>>(
+            finder->findPath(start, end));
+
+        return [this, result]()
+        {
+            m_path = std::move(result->first);
+            m_iteration = std::move(result->second);
+            m_iterIndex = 0;
+        };
+    });
+}
+
+void MazeVisualizerApp::onToggleWall()
+{
+    if (isBusy() || !m_maze->toggleWall(m_wallCell.x, m_wallCell.y))
+        return;
+
+    // Solve again right away, LPA* only repairs around the edited cell
+    m_path.clear();
+    m_iteration.clear();
+    onFind();
+}
+
+bool MazeVisualizerApp::isBusy() const
+{
+    return m_worker.isBusy() || m_stepper;
+}
+
+void MazeVisualizerApp::drawWorkerStatus()
+{
+    if (m_stepper)
+    {
+        ImGui::Text("Live search: %llu cells expanded",
+                    (unsigned long long)m_stepper->getLastExpansions());
+    }
+    else if (m_job == Job::Solve)
+    {
+        // Every open cell is expanded at most once
+        uint64_t expansions = m_progress.getExpansions();
+        float fraction = m_progressTotal > 0
+            ? std::min(1.0f, (float)expansions / m_progressTotal)
+            : 0.0f;
+        std::string overlay = std::to_string(expansions) + " cells expanded";
+        ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay.c_str());
+    }
+    else
+    {
+        ImGui::ProgressBar(0.0f, ImVec2(-1.0f, 0.0f), "Generating...");
+    }
+
+    if (ImGui::Button("Cancel"))
+        m_cancel.cancel();
+}
+
+std::shared_ptr<Maze> MazeVisualizerApp::createMaze(int algo,
+                                                    uint32_t width,
+                                                    uint32_t height) const
+{
+    switch (algo)
+    {
+    case 1:  return std::make_shared<KruskalMaze>(width, height);
+    case 2:  return std::make_shared<PrimMaze>(width, height);
+    case 3:  return std::make_shared<EllerMaze>(width, height);
+    case 4:  return std::make_shared<SidewinderMaze>(width, height);
+    case 5:  return std::make_shared<BinaryTreeMaze>(width, height);
+    case 6:  return std::make_shared<WilsonMaze>(width, height);
+    default: return std::make_shared<RecursiveBacktrackingMaze>(width, height);
+    }
 }
 
 void MazeVisualizerApp::onClear()
@@ -4,8 +4,12 @@
 #include "application.h"
 #include "renderer.h"
 #include "maze.h"
+#include "pathcache.h"
+#include "parallelbfspathfinder.h"
+#include "backgroundworker.h"
 
 #include <memory>
+#include <string>
 
 class MazeVisualizerApp : public Application
 {
@@ -19,14 +23,23 @@ public:
 
 protected:
     void onRandomize();
+    void onLoad(const std::string& path);
+    void onToggleWall();
 
     void onFind();
+    bool isBusy() const;
+    void drawWorkerStatus();
+    void drawIteration(const IterationData& iterData);
     void onClear();
     void onPlay();
     void onPause();
     void onNext();
     void onPrev();
 
+    std::shared_ptr<Maze> createMaze(int algo,
+                                     uint32_t width,
+                                     uint32_t height) const;
+
     virtual void onKeyInput(int key,
                             int scancode,
                             int action,
@@ -38,6 +51,7 @@ private:
     std::shared_ptr<PathFinder> m_finder;
     std::vector<Point> m_path;
     Point m_start, m_end;
+    Point m_wallCell = { 1, 0 }; // Cell edited by the wall toggle
     glm::vec3 m_startPointColor, m_endPointColor;
     std::pair<uint32_t, uint32_t> m_mazeSize;
 
@@ -46,9 +60,30 @@ private:
     std::vector<IterationData> m_iteration;
     bool m_showFinalPath = true;
     bool m_visualize = false;
+    bool m_liveSearch = false;
+    int m_stepsPerFrame = 50;
+    std::shared_ptr<PathFinder> m_stepper; // Resumable solver being stepped live
+    int m_timeBudgetMs = 0;    // Zero means no deadline
+    int m_expansionBudget = 0; // Zero means no budget
+
+    int m_mazeAlgo = 0;
+    float m_braidRatio = 0.0f; // Applied on the next Randomize
+    bool m_tiledLayout = false;
+    int m_topology = 0; // Index of Maze::Topology
+    std::array<std::shared_ptr<Maze>, 7> m_mazes;
+    std::array<std::shared_ptr<Maze>, 7> m_backMazes; // Randomize generates into these, then swaps
+    std::array<std::shared_ptr<PathFinder>, 9> m_pathFinders;
+    std::shared_ptr<ParallelBFSPathFinder> m_parallelBFS; // Also in m_pathFinders, kept for its level stats
+    std::shared_ptr<PathCache> m_pathCache;
+
+    enum class Job { Solve, Generate };
+    Job m_job = Job::Solve;
+    CancellationToken m_cancel;
+    SearchProgress m_progress;
+    uint64_t m_progressTotal = 0;
 
-    std::array<std::shared_ptr<Maze>, 3> m_mazes;
-    std::array<std::shared_ptr<PathFinder>, 3> m_pathFinders;
+    // Last, so it is joined before anything its jobs touch is destroyed
+    BackgroundWorker m_worker;
 };
 
 #endif // MAZEVISUALIZERAPP_H
@@ -0,0 +1,125 @@
+#include "parallelbfspathfinder.h"
+
+#include <cstdlib>
+
+ParallelBFSPathFinder::ParallelBFSPathFinder(unsigned threadCount)
+    : m_field(threadCount)
+{
+}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+ParallelBFSPathFinder::findPath(Point start, Point end)
+{
+    beginSearch();
+
+    const auto& maze = getMaze();
+    if (!maze->isValidCell(start.x, start.y) || maze->isWall(start.x, start.y) ||
+        !maze->isValidCell(end.x, end.y) || maze->isWall(end.x, end.y))
+    {
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+
+    m_field.setTarget(end);
+    m_field.setStopCondition([this](size_t frontier) { return shouldStop(frontier); });
+    m_field.compute(*maze, start);
+
+    Point target = end;
+    if (m_field.at(end.x, end.y) != DistanceField::unreachable)
+    {
+        setLastStatus(SearchStatus::Found);
+    }
+    else if (!m_field.wasStopped())
+    {
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+    else
+    {
+        // Stopped early, head for the reached cell closest to the end
+        int best = INT32_MAX;
+        for (uint32_t y = 0; y < m_field.getHeight(); y++)
+        {
+            for (uint32_t x = 0; x < m_field.getWidth(); x++)
+            {
+                int d = std::abs((int)x - end.x) + std::abs((int)y - end.y);
+                if (d < best && m_field.at(x, y) != DistanceField::unreachable)
+                {
+                    best = d;
+                    target = Point{(int)x, (int)y};
+                }
+            }
+        }
+    }
+
+    auto path = walkBack(target);
+
+    std::vector<IterationData> iterData;
+    if (isTraceEnabled())
+        iterData = buildTrace(m_field.getMaxDistance());
+
+    return std::make_pair(path, iterData);
+}
+
+const std::vector<DistanceField::LevelStats>& ParallelBFSPathFinder::getLevelStats() const
+{
+    return m_field.getLevelStats();
+}
+
+unsigned ParallelBFSPathFinder::getThreadCount() const
+{
+    return m_field.getThreadCount();
+}
+
+std::vector<Point> ParallelBFSPathFinder::walkBack(Point cell) const
+{
+    // Walk back down the distance field to the start
+    uint32_t depth = m_field.at(cell.x, cell.y);
+    std::vector<Point> path(depth + 1);
+    for (uint32_t d = depth; ; d--)
+    {
+        path[d] = cell;
+        if (d == 0)
+            break;
+
+        for (int dir = 0; dir < 4; dir++)
+        {
+            Point prev = { cell.x + Maze::dx[dir], cell.y + Maze::dy[dir] };
+            if (m_field.at(prev.x, prev.y) == d - 1)
+            {
+                cell = prev;
+                break;
+            }
+        }
+    }
+
+    return path;
+}
+
+std::vector<IterationData> ParallelBFSPathFinder::buildTrace(uint32_t depth) const
+{
+    // One iteration per level, showing the wave of newly reached cells
+    std::vector<IterationData> iterData(depth);
+    std::vector<bool> hasCurrent(depth, false);
+
+    for (uint32_t y = 0; y < m_field.getHeight(); y++)
+    {
+        for (uint32_t x = 0; x < m_field.getWidth(); x++)
+        {
+            uint32_t d = m_field.at(x, y);
+            if (d == DistanceField::unreachable)
+                continue;
+
+            Point p = { (int)x, (int)y };
+            if (d > 0 && d <= depth)
+                iterData[d - 1].neighbors[p] = d;
+            if (d < depth && !hasCurrent[d])
+            {
+                iterData[d].currentPoint = p;
+                hasCurrent[d] = true;
+            }
+        }
+    }
+
+    return iterData;
+}
@@ -0,0 +1,32 @@
+#ifndef PARALLELBFSPATHFINDER_H
+#define PARALLELBFSPATHFINDER_H
+
+#include "pathfinder.h"
+#include "distancefield.h"
+
+// BFS for very large grids, run as a multi-threaded, direction-optimizing
+// distance field sweep that stops at the end cell. The path is then walked
+// back down the distances.
+class ParallelBFSPathFinder : public PathFinder
+{
+public:
+    // Zero threads picks one per hardware thread
+    explicit ParallelBFSPathFinder(unsigned threadCount = 0);
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    // Per-level timing of the last search
+    const std::vector<DistanceField::LevelStats>& getLevelStats() const;
+    unsigned getThreadCount() const;
+
+private:
+    std::vector<Point> walkBack(Point cell) const;
+    std::vector<IterationData> buildTrace(uint32_t depth) const;
+
+private:
+    DistanceField m_field;
+};
+
+#endif // PARALLELBFSPATHFINDER_H
@@ -0,0 +1,68 @@
+#include "pathcache.h"
+
+PathCache::PathCache(size_t capacity)
+    : m_capacity(capacity)
+{}
+
+const PathCache::Result* PathCache::find(const PathCacheKey &key)
+{
+    auto it = m_lookup.find(key);
+    if (it == m_lookup.end())
+    {
+        m_misses++;
+        return nullptr;
+    }
+
+    m_hits++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->second;
+}
+
+void PathCache::insert(const PathCacheKey &key, const Result &result)
+{
+    if (m_capacity == 0)
+        return;
+
+    auto it = m_lookup.find(key);
+    if (it != m_lookup.end())
+    {
+        it->second->second = result;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+
+    if (m_entries.size() >= m_capacity)
+    {
+        m_lookup.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+
+    m_entries.emplace_front(key, result);
+    m_lookup[key] = m_entries.begin();
+}
+
+void PathCache::clear()
+{
+    m_entries.clear();
+    m_lookup.clear();
+}
+
+size_t PathCache::size() const
+{
+    return m_entries.size();
+}
+
+size_t PathCache::getCapacity() const
+{
+    return m_capacity;
+}
+
+uint64_t PathCache::getHits() const
+{
+    return m_hits;
+}
+
+uint64_t PathCache::getMisses() const
+{
+    return m_misses;
+}
@@ -0,0 +1,71 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "pathfinder.h"
+
+#include <list>
+
+struct PathCacheKey
+{
+    uint64_t mazeHash;
+    size_t solver;
+    uint64_t variant; // PathFinder::getVariant()
+    bool trace;       // Results without a trace can't serve a traced query
+    Point start, end;
+
+    bool operator==(const PathCacheKey& other) const
+    {
+        return mazeHash == other.mazeHash &&
+               solver == other.solver &&
+               variant == other.variant &&
+               trace == other.trace &&
+               start == other.start &&
+               end == other.end;
+    }
+};
+
+struct PathCacheKeyHash
+{
+    size_t operator()(const PathCacheKey& key) const
+    {
+        size_t h = std::hash<uint64_t>()(key.mazeHash);
+        h ^= key.solver + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= key.variant * 2 + key.trace + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= PointHash()(key.start) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= PointHash()(key.end) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// Bounded least-recently-used cache of solver results
+class PathCache
+{
+public:
+    using Result = std::pair<std::vector<Point>,
+                             std::vector<IterationData>>;
+
+public:
+    explicit PathCache(size_t capacity = 64);
+
+    const Result* find(const PathCacheKey& key);
+    void insert(const PathCacheKey& key, const Result& result);
+    void clear();
+
+    size_t size() const;
+    size_t getCapacity() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+
+private:
+    using Entry = std::pair<PathCacheKey, Result>;
+
+    size_t m_capacity;
+    std::list<Entry> m_entries; // Most recently used first
+    std::unordered_map<PathCacheKey,
+                       std::list<Entry>::iterator,
+                       PathCacheKeyHash> m_lookup;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+#endif // PATHCACHE_H
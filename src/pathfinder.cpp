@@ -1,11 +1,54 @@
 #include "pathfinder.h"
-#include "renderer.h"
+#include "mazeexporter.h"
+#include "solvercore.h"
 
-#include <GLFW/glfw3.h>
+#include <iostream>
+
+const char* searchStatusName(SearchStatus status)
+{
+    switch (status)
+    {
+    case SearchStatus::Found:           return "Found";
+    case SearchStatus::NoPath:          return "No path";
+    case SearchStatus::Cancelled:       return "Cancelled";
+    case SearchStatus::DeadlineExpired: return "Deadline expired";
+    case SearchStatus::BudgetExhausted: return "Budget exhausted";
+    }
+    return "Unknown";
+}
 
+CancellationToken::CancellationToken()
+    : m_flag(std::make_shared<std::atomic<bool>>(false))
+{}
 
-#include <iostream>
-#include <algorithm>
+void CancellationToken::cancel() const
+{
+    m_flag->store(true, std::memory_order_relaxed);
+}
+
+void CancellationToken::reset() const
+{
+    m_flag->store(false, std::memory_order_relaxed);
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return m_flag->load(std::memory_order_relaxed);
+}
+
+SearchProgress::SearchProgress()
+    : m_expansions(std::make_shared<std::atomic<uint64_t>>(0))
+{}
+
+void SearchProgress::publish(uint64_t expansions) const
+{
+    m_expansions->store(expansions, std::memory_order_relaxed);
+}
+
+uint64_t SearchProgress::getExpansions() const
+{
+    return m_expansions->load(std::memory_order_relaxed);
+}
 
 PathFinder::PathFinder(const std::shared_ptr<Maze>& maze)
     : m_maze(maze)
@@ -13,80 +56,312 @@ PathFinder::PathFinder(const std::shared_ptr<Maze>& maze)
 
 void PathFinder::printPath(const std::vector<Point> &path) const
 {
-    auto height = m_maze->getHeight();
-    auto width = m_maze->getWidth();
-    const auto& grid = m_maze->getGrid();
-    std::vector<std::vector<char>> display(height, std::vector<char>(width, ' '));
+    std::cout << std::flush;
+
+    AsciiGlyphs glyphs;
+    glyphs.wall = "|";
+
+    BufferedWriter out(stdout);
+    MazeExporter::exportMaze(*m_maze, path, out,
+                             MazeExporter::Format::Ascii,
+                             glyphs);
+}
+
+void PathFinder::setMaze(const std::shared_ptr<Maze> &maze)
+{
+    m_maze = maze;
+}
+
+const std::shared_ptr<Maze>& PathFinder::getMaze() const
+{
+    return m_maze;
+}
+
+void PathFinder::setTraceEnabled(bool enabled)
+{
+    m_traceEnabled = enabled;
+}
+
+bool PathFinder::isTraceEnabled() const
+{
+    return m_traceEnabled;
+}
+
+void PathFinder::setSearchLimits(const SearchLimits& limits)
+{
+    m_limits = limits;
+}
+
+const SearchLimits& PathFinder::getSearchLimits() const
+{
+    return m_limits;
+}
+
+SearchStatus PathFinder::getLastStatus() const
+{
+    return m_status;
+}
+
+uint64_t PathFinder::getLastExpansions() const
+{
+    return m_expansions;
+}
+
+bool PathFinder::supportsTopology(Maze::Topology topology) const
+{
+    return topology == Maze::Topology::Square4;
+}
+
+uint64_t PathFinder::getVariant() const
+{
+    return 0;
+}
+
+bool PathFinder::isResumable() const
+{
+    return false;
+}
+
+void PathFinder::begin(Point start, Point end)
+{
+    m_events.clear();
+    m_lastStep = IterationData();
+    m_lastStepBuilt = true;
+    m_stepResult.clear();
+    m_finished = false;
+    m_stepParents = nullptr;
+
+    if (!onBegin(start, end))
+        m_finished = true;
+}
+
+bool PathFinder::step(uint64_t maxExpansions)
+{
+    m_events.clear();
+    m_lastStepBuilt = false;
+
+    if (!m_finished)
+        onStep(maxExpansions);
+
+    return !m_finished;
+}
+
+bool PathFinder::isFinished() const
+{
+    return m_finished;
+}
+
+const std::vector<SearchEvent>& PathFinder::getLastEvents() const
+{
+    return m_events;
+}
+
+const IterationData& PathFinder::getLastStep() const
+{
+    if (!m_lastStepBuilt)
+    {
+        m_lastStep = IterationData();
+        buildIteration(m_lastStep);
+        m_lastStepBuilt = true;
+    }
+    return m_lastStep;
+}
+
+const std::vector<Point>& PathFinder::getStepResult() const
+{
+    return m_stepResult;
+}
+
+bool PathFinder::onBegin(Point start, Point end)
+{
+    m_stepResult = findPath(start, end).first;
+    return false;
+}
+
+void PathFinder::onStep(uint64_t)
+{
+    m_finished = true;
+}
+
+void PathFinder::finish(std::vector<Point> path)
+{
+    m_stepResult = std::move(path);
+    m_finished = true;
+}
 
-    // Fill with maze
-    for (int y = 0; y < height; ++y)
+void PathFinder::buildIteration(IterationData& it) const
+{
+    bool expanded = false;
+    for (const SearchEvent& event : m_events)
     {
-        for (int x = 0; x < width; ++x)
+        if (event.type == SearchEvent::Type::Expand)
         {
-            display[y][x] = grid[y][x] ? '|' : ' ';
+            it.currentPoint = event.cell;
+            expanded = true;
+        }
+        else if (event.type == SearchEvent::Type::Discover)
+        {
+            it.neighbors[event.cell] = event.value;
         }
     }
 
-    // Mark path
-    for (const auto& p : path)
+    // One route per step rather than per expansion keeps big steps cheap
+    if (expanded && !m_finished && m_stepParents)
     {
-        display[p.y][p.x] = '*';
+        it.path = SolverCore::reconstruct(*m_stepParents, cellIndex(it.currentPoint),
+                                          m_startCell, m_maze->getWidth());
     }
+}
+
+void PathFinder::beginSearch()
+{
+    m_status = SearchStatus::NoPath;
+    m_expansions = 0;
+    m_nextCheck = 0;
+    m_limits.progress.publish(0);
+}
+
+bool PathFinder::setEndpoints(Point start, Point end)
+{
+    beginSearch();
 
-    // Print
-    for (const auto& row : display)
+    if (!m_maze->isValidCell(start.x, start.y) ||
+        !m_maze->isValidCell(end.x, end.y))
     {
-        for (char cell : row)
-        {
-            std::cout << cell;
-        }
-        std::cout << std::endl;
+        return false;
     }
 
+    m_startCell = cellIndex(start);
+    m_endCell = cellIndex(end);
+    return true;
 }
 
-void PathFinder::setMaze(const std::shared_ptr<Maze> &maze)
+bool PathFinder::beginCoreSearch(Point start, Point end)
 {
-    m_maze = maze;
+    m_events.clear();
+    m_lastStep = IterationData();
+    m_lastStepBuilt = true;
+    m_stepResult.clear();
+    m_finished = true;
+    m_stepParents = nullptr;
+
+    return setEndpoints(start, end);
 }
 
-const std::shared_ptr<Maze>& PathFinder::getMaze() const
+std::vector<Point>
+PathFinder::finishCoreSearch(uint32_t last,
+                             const std::pmr::vector<uint32_t>& cameFrom)
 {
-    return m_maze;
+    if (last == invalidCell)
+        return std::vector<Point>();
+
+    if (last == m_endCell)
+        m_status = SearchStatus::Found;
+
+    return SolverCore::reconstruct(cameFrom, last, m_startCell, m_maze->getWidth());
 }
 
-std::vector<Point> PathFinder::getNeighbors(const Point &p) const
+bool PathFinder::shouldStop(uint64_t expansions)
 {
-    std::vector<Point> neighbors;
+    if (m_limits.token.isCancelled())
+    {
+        m_status = SearchStatus::Cancelled;
+        return true;
+    }
+
+    if (m_limits.maxExpansions != 0 &&
+        m_expansions + expansions > m_limits.maxExpansions)
+    {
+        m_status = SearchStatus::BudgetExhausted;
+        return true;
+    }
+
+    m_expansions += expansions;
 
-    for (uint8_t i = 0; i < 4; i++)
+    if (m_expansions >= m_nextCheck)
     {
-        auto nx = p.x + Maze::dx[i];
-        auto ny = p.y + Maze::dy[i];
+        m_nextCheck = m_expansions + s_checkInterval;
+        m_limits.progress.publish(m_expansions);
 
-        if (m_maze->isValidCell(nx, ny) &&
-            !m_maze->isWall(nx, ny))
+        if (m_limits.deadline != std::chrono::steady_clock::time_point::max() &&
+            std::chrono::steady_clock::now() >= m_limits.deadline)
         {
-            neighbors.push_back(Point{nx, ny});
+            m_status = SearchStatus::DeadlineExpired;
+            return true;
         }
     }
 
-    return neighbors;
+    return false;
 }
 
-std::vector<Point>
-PathFinder::reconstructPath(std::unordered_map<Point, Point, PointHash> &cameFrom,
-                            Point current)
+void PathFinder::setLastStatus(SearchStatus status)
 {
-    std::vector<Point> path;
-    path.push_back(current);
+    m_status = status;
+}
 
-    while (cameFrom.find(current) != cameFrom.end())
+Neighbors PathFinder::getNeighbors(const Point &p) const
+{
+    Neighbors neighbors;
+
+    // The square neighbours are the common case and skip the move policies
+    if (m_maze->getTopology() == Maze::Topology::Square4)
     {
-        current = cameFrom[current];
-        path.push_back(current);
+        uint8_t open = m_maze->getOpenSides(p.x, p.y);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            if (open & (1 << i))
+                neighbors.points[neighbors.count++] = Point{p.x + Maze::dx[i], p.y + Maze::dy[i]};
+        }
+        return neighbors;
     }
 
-    std::reverse(path.begin(), path.end());
-    return path;
+    SolverCore::withMoves(m_maze->getTopology(), [&](auto moves)
+    {
+        using Moves = decltype(moves);
+
+        uint8_t open = Moves::open(SolverCore::CheckedGrid(*m_maze), p.x, p.y);
+        for (int i = 0; i < Moves::count; i++)
+        {
+            if (open & (1 << i))
+                neighbors.points[neighbors.count++] = Point{p.x + Moves::dx(i, p.y), p.y + Moves::dy(i)};
+        }
+    });
+
+    return neighbors;
+}
+
+uint32_t PathFinder::stepCost(const Point& from, const Point& to) const
+{
+    using Square8 = SolverCore::SquareMoves<8>;
+
+    uint32_t cost = m_maze->getCost(to.x, to.y);
+    if (m_maze->getTopology() != Maze::Topology::Square8)
+        return cost;
+
+    bool diagonal = from.x != to.x && from.y != to.y;
+    return cost * (diagonal ? Square8::diagonalWeight : Square8::straightWeight);
+}
+
+int PathFinder::distanceBound(const Point& a, const Point& b) const
+{
+    return SolverCore::withMoves(m_maze->getTopology(), [&](auto moves)
+    {
+        return decltype(moves)::distance(a, b);
+    });
+}
+
+uint32_t PathFinder::cellIndex(const Point &p) const
+{
+    return (uint32_t)p.y * m_maze->getWidth() + (uint32_t)p.x;
+}
+
+Point PathFinder::cellPoint(uint32_t index) const
+{
+    return Point{(int)(index % m_maze->getWidth()),
+                 (int)(index / m_maze->getWidth())};
+}
+
+uint32_t PathFinder::cellCount() const
+{
+    return m_maze->getWidth() * m_maze->getHeight();
 }
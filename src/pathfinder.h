@@ -5,6 +5,10 @@
 
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
+#include <array>
+#include <atomic>
+#include <chrono>
 
 struct Point
 {
@@ -29,6 +33,17 @@ struct PointHash
     }
 };
 
+// Open neighbours of a cell, at most eight, held inline so that producing
+// them never touches the heap
+struct Neighbors
+{
+    std::array<Point, 8> points;
+    uint8_t count = 0;
+
+    const Point* begin() const { return points.data(); }
+    const Point* end() const { return points.data() + count; }
+};
+
 struct IterationData
 {
     Point currentPoint;
@@ -36,6 +51,73 @@ struct IterationData
     std::unordered_map<Point, int, PointHash> neighbors;
 };
 
+// One thing a resumable search did, in the order it did it
+struct SearchEvent
+{
+    enum class Type
+    {
+        Expand,   // cell was taken off the open set and expanded
+        Discover, // cell was reached, value is its score in the solver's terms
+        Finish    // The search is over, cell is the end and value the number of
+                  // cells on getStepResult(), see getLastStatus() for why
+    };
+
+    Type type;
+    Point cell;
+    int value = 0;
+};
+
+// Outcome of the last findPath call
+enum class SearchStatus
+{
+    Found,
+    NoPath,
+    Cancelled,       // The cancellation token was triggered
+    DeadlineExpired,
+    BudgetExhausted  // The node expansion budget ran out
+};
+
+const char* searchStatusName(SearchStatus status);
+
+// Flag another thread can raise to abort a running search. Copies share the
+// same flag.
+class CancellationToken
+{
+public:
+    CancellationToken();
+
+    void cancel() const;
+    void reset() const;
+    bool isCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_flag;
+};
+
+// Expansion count a running search publishes for other threads to read.
+// Copies share the same counter.
+class SearchProgress
+{
+public:
+    SearchProgress();
+
+    void publish(uint64_t expansions) const;
+    uint64_t getExpansions() const;
+
+private:
+    std::shared_ptr<std::atomic<uint64_t>> m_expansions;
+};
+
+// Checked by the solvers as they expand cells
+struct SearchLimits
+{
+    CancellationToken token;
+    SearchProgress progress;
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::time_point::max();
+    uint64_t maxExpansions = 0; // Zero means no budget
+};
+
 class PathFinder
 {
 public:
@@ -50,14 +132,121 @@ public:
     void setMaze(const std::shared_ptr<Maze>& maze);
     const std::shared_ptr<Maze>& getMaze() const;
 
+    // Whether the solver searches every move of the topology. The others
+    // search the four square moves only. Their paths stay valid in every
+    // topology, but they need not be the shortest, and where only a
+    // diagonal or hex move gets through they find no path at all. Only
+    // Square4 by default.
+    virtual bool supportsTopology(Maze::Topology topology) const;
+
+    // Settings of the solver that change what findPath returns for the
+    // same maze and endpoints, so a cache can tell the results apart.
+    // Zero for solvers without any.
+    virtual uint64_t getVariant() const;
+
+    // With the trace off findPath returns no IterationData and the search
+    // itself does not allocate once its scratch buffers have grown
+    void setTraceEnabled(bool enabled);
+    bool isTraceEnabled() const;
+
+    // When a limit stops a search, findPath returns a best-effort partial
+    // path from the start towards the end and getLastStatus() says why
+    void setSearchLimits(const SearchLimits& limits);
+    const SearchLimits& getSearchLimits() const;
+    SearchStatus getLastStatus() const;
+    uint64_t getLastExpansions() const;
+
+    // Resumable search. begin() sets a search up and step() expands up to
+    // maxExpansions cells, returning false once the search is over; the
+    // path is then in getStepResult(). Solvers that are not resumable do
+    // all their work in begin().
+    virtual bool isResumable() const;
+    void begin(Point start, Point end);
+    bool step(uint64_t maxExpansions);
+    bool isFinished() const;
+    // Events of the last step(), recorded with the trace off too
+    const std::vector<SearchEvent>& getLastEvents() const;
+    // The last step() as an iteration: the last cell it expanded, the route
+    // to that cell and every cell it discovered. Built on first use.
+    const IterationData& getLastStep() const;
+    const std::vector<Point>& getStepResult() const;
+
 protected:
-    std::vector<Point> getNeighbors(const Point& p) const;
-    std::vector<Point> reconstructPath(
-        std::unordered_map<Point, Point, PointHash>& cameFrom,
-        Point current);
+    static constexpr uint32_t invalidCell = UINT32_MAX;
+
+    // Open neighbours of a valid cell in the maze's topology
+    Neighbors getNeighbors(const Point& p) const;
+    // Cost of stepping between neighbours, the cost of entering to times the
+    // weight of the move, which only Square8 diagonals make more than one
+    uint32_t stepCost(const Point& from, const Point& to) const;
+    // Lower bound on the move weights between two cells
+    int distanceBound(const Point& a, const Point& b) const;
+
+    // Flat row-major index of a cell, used to address per-cell scratch arrays
+    uint32_t cellIndex(const Point& p) const;
+    Point cellPoint(uint32_t index) const;
+    uint32_t cellCount() const;
+
+    // Sets up a resumable search, returns false if it is already over.
+    // The default runs findPath() to completion.
+    virtual bool onBegin(Point start, Point end);
+    // Carries a resumable search on for up to maxExpansions cells, calling
+    // finish() once it is over
+    virtual void onStep(uint64_t maxExpansions);
+    void finish(std::vector<Point> path);
+
+    // Called at the top of findPath, the status starts out as NoPath
+    void beginSearch();
+    // Counts expansions against the limits, records why and returns true
+    // once the search has to stop
+    bool shouldStop(uint64_t expansions = 1);
+    void setLastStatus(SearchStatus status);
+
+    // findPath(), onBegin() and onStep() of the solvers built on a
+    // SolverCore search, defined in solvercore.h. findPath() draws the
+    // search from the thread's ScratchArena and ends any stepped search,
+    // while a stepped one runs on a search the solver keeps.
+    template <class Search>
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findCorePath(Point start, Point end);
+    template <class Search>
+    bool beginCoreSteps(Search& search, Point start, Point end);
+    template <class Search>
+    void stepCore(Search& search, uint64_t maxExpansions);
+
+protected:
+    uint32_t m_startCell = invalidCell;
+    uint32_t m_endCell = invalidCell;
 
 private:
+    // Reading the clock or publishing progress costs more than an
+    // expansion, so both happen this often
+    static constexpr uint64_t s_checkInterval = 1024;
+
     std::shared_ptr<Maze> m_maze;
+    bool m_traceEnabled = true;
+
+    SearchLimits m_limits;
+    SearchStatus m_status = SearchStatus::NoPath;
+    uint64_t m_expansions = 0;
+    uint64_t m_nextCheck = 0;
+
+    bool m_finished = true;
+    std::vector<SearchEvent> m_events;
+    mutable IterationData m_lastStep;
+    mutable bool m_lastStepBuilt = false;
+    std::vector<Point> m_stepResult;
+    // Parent tree of the stepped search, owned by the solver's search
+    const std::pmr::vector<uint32_t>* m_stepParents = nullptr;
+
+private:
+    void buildIteration(IterationData& it) const;
+    // Begins the search and sets the end cells, false if either is not valid
+    bool setEndpoints(Point start, Point end);
+    bool beginCoreSearch(Point start, Point end);
+    // The path to the cell a search returned, the end being found
+    std::vector<Point> finishCoreSearch(uint32_t last,
+                                        const std::pmr::vector<uint32_t>& cameFrom);
 };
 
 #endif // PATHFINDER_H
@@ -4,55 +4,51 @@ PrimMaze::PrimMaze(uint32_t width,
                    uint32_t height)
     : Maze(width, height)
 {
+    m_generatorName = "Prim";
 }
 
-void PrimMaze::generate(uint32_t seed)
+void PrimMaze::onGenerate()
 {
-    Maze::generate(seed);
-
-    // Get modifiable grid
-    auto& grid = const_cast<std::vector<std::vector<int>>&>(getGrid());
-
-    // Vector to store walls
-    std::vector<Wall> walls;
+    // Empty the walls left over from the last call
+    m_walls.clear();
 
     // Start from cell (0,0)
     int startX = 0;
     int startY = 0;
 
     // Mark the starting cell as part of the maze
-    grid[startY][startX] = 0;
+    setWall(startX, startY, false);
 
     // Add the walls around the starting cell
-    addWalls(walls, startX, startY);
+    addWalls(startX, startY);
 
     // While there are walls to process
-    while (!walls.empty())
+    while (!m_walls.empty())
     {
         // Randomly select a wall
-        std::uniform_int_distribution<size_t> dist(0, walls.size() - 1);
+        std::uniform_int_distribution<size_t> dist(0, m_walls.size() - 1);
         size_t wallIndex = dist(m_rng);
-        Wall currentWall = walls[wallIndex];
+        Wall currentWall = m_walls[wallIndex];
 
         // Remove the selected wall from the vector
-        walls[wallIndex] = walls.back();
-        walls.pop_back();
+        m_walls[wallIndex] = m_walls.back();
+        m_walls.pop_back();
 
         // If the cell on the other side of the wall isn't in the maze yet
         if (isWall(currentWall.nx, currentWall.ny))
         {
             // Add the cell to the maze
-            grid[currentWall.ny][currentWall.nx] = 0;
+            setWall(currentWall.nx, currentWall.ny, false);
             // Remove the wall between the cells
-            grid[currentWall.y][currentWall.x] = 0;
+            setWall(currentWall.x, currentWall.y, false);
 
             // Add new walls to consider
-            addWalls(walls, currentWall.nx, currentWall.ny);
+            addWalls(currentWall.nx, currentWall.ny);
         }
     }
 }
 
-void PrimMaze::addWalls(std::vector<Wall> &walls, int x, int y)
+void PrimMaze::addWalls(int x, int y)
 {
     // Use the direction arrays from base class
     for (int i = 0; i < 4; i++)
@@ -69,7 +65,7 @@ void PrimMaze::addWalls(std::vector<Wall> &walls, int x, int y)
             {
                 // Add the wall between current cell and next cell
                 // Wall coordinates are halfway between current and next cell
-                walls.emplace_back(x + dx[i], y + dy[i], nx, ny);
+                m_walls.emplace_back(x + dx[i], y + dy[i], nx, ny);
             }
         }
     }
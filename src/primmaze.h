@@ -25,11 +25,16 @@ public:
     PrimMaze(uint32_t width = 21,
              uint32_t height = 21);
 
-    virtual void generate(uint32_t seed) override;
+protected:
+    virtual void onGenerate() override;
 
 private:
     // Helper method to add walls around an unvisited cell
-    void addWalls(std::vector<Wall>& walls, int x, int y);
+    void addWalls(int x, int y);
+
+private:
+    // Frontier of walls, kept between calls to reuse its capacity
+    std::vector<Wall> m_walls;
 };
 
 #endif // PRIMMAZE_H
@@ -7,11 +7,11 @@ RecursiveBacktrackingMaze::RecursiveBacktrackingMaze(uint32_t width,
                                                      uint32_t height)
     : Maze(width, height)
 {
+    m_generatorName = "Backtracking";
 }
 
-void RecursiveBacktrackingMaze::generate(uint32_t seed)
+void RecursiveBacktrackingMaze::onGenerate()
 {
-    Maze::generate(seed);
     recursiveBacktracking(0, 0);
 }
 
@@ -22,16 +22,16 @@ void RecursiveBacktrackingMaze::recursiveBacktracking(int cx, int cy)
                  directions.end(),
                  m_rng);
 
-    m_grid[cy][cx] = 0;
+    setWall(cx, cy, false);
 
     for (auto dir : directions)
     {
         int nx = cx + dx[dir] * 2;
         int ny = cy + dy[dir] * 2;
 
-        if (isValidCell(nx, ny) && m_grid[ny][nx] == 1)
+        if (isValidCell(nx, ny) && isWall(nx, ny))
         {
-            m_grid[cy + dy[dir]][cx + dx[dir]] = 0;
+            setWall(cx + dx[dir], cy + dy[dir], false);
 
             recursiveBacktracking(nx, ny);
         }
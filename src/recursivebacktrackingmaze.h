@@ -9,7 +9,8 @@ public:
     RecursiveBacktrackingMaze(uint32_t width = 21,
                               uint32_t height = 21);
 
-    virtual void generate(uint32_t seed) override;
+protected:
+    virtual void onGenerate() override;
 
 private:
     void recursiveBacktracking(int cx, int cy);
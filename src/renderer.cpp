@@ -12,6 +12,7 @@
 #include <imgui_impl_glfw.h>
 
 #include <string>
+#include <algorithm>
 
 #define VERTEX_SHADER_PATH   "resources/shaders/vertex.glsl"
 #define FRAGMENT_SHADER_PATH "resources/shaders/fragment.glsl"
@@ -109,31 +110,60 @@ void Renderer::drawQuad(const glm::vec3& position,
     s_data.modelIndex   += 1.0f;
 }
 
+glm::vec2 Renderer::cellSize(const Maze& maze)
+{
+    // Calculate quad size based on window dimensions
+    float quadWidth = 2.0f / maze.getHeight();
+    float quadHeight = 2.0f / maze.getWidth();
+
+    // Shifted rows stick out half a cell, which has to fit as well
+    if (maze.getTopology() == Maze::Topology::Hex)
+        quadWidth *= maze.getWidth() / (maze.getWidth() + 0.5f);
+
+    return glm::vec2(quadWidth, quadHeight);
+}
+
+glm::vec2 Renderer::cellCenter(const Maze& maze, const Point& p)
+{
+    glm::vec2 size = cellSize(maze);
+
+    float xPos = -1.0f + p.x * size.x + size.x / 2.0f;
+    float yPos = -1.0f + p.y * size.y + size.y / 2.0f;
+    if (maze.getTopology() == Maze::Topology::Hex && (p.y & 1))
+        xPos += size.x / 2.0f;
+
+    return glm::vec2(xPos, yPos);
+}
+
 void Renderer::drawMaze(const Maze &maze)
 {
-    const auto& grid = maze.getGrid();
-    auto rows = grid.size();
-    auto cells = grid[0].size();
+    auto rows = maze.getHeight();
+    auto cells = maze.getWidth();
+    float maxCost = maze.getMaxCost();
 
-    // Calculate quad size based on window dimensions
-    float quadWidth = 2.0f / rows;
-    float quadHeight = 2.0f / cells;
+    glm::vec2 size = cellSize(maze);
 
     for (int y = 0; y < rows; ++y)
     {
         for (int x = 0; x < cells; ++x)
         {
             // Calculate position in normalized device coordinates
-            float xPos = -1.0f + x * quadWidth + quadWidth / 2.0f;
-            float yPos = -1.0f + y * quadHeight + quadHeight / 2.0f;
+            glm::vec2 center = cellCenter(maze, Point{x, y});
 
             glm::vec3 color = maze.isWall(x, y) ?
                                   glm::vec3(0.3f, 0.5f, 0.7f) :
                                   glm::vec3(0.0f);
 
+            // Tint open cells by how expensive they are to cross
+            if (maze.hasCosts() && !maze.isWall(x, y))
+            {
+                float t = (maze.getCost(x, y) - 1) / std::max(maxCost - 1.0f, 1.0f);
+                color = glm::vec3(0.45f * t, 0.3f * t, 0.1f * t);
+            }
+
 
-            drawQuad(glm::vec3(xPos, yPos, 0.0f),
-                     glm::vec3(quadWidth, quadHeight, 1.0f),
+            drawQuad(glm::vec3(center, 0.0f),
+                     glm::vec3(size, 1.0f),
                      color);
         }
     }
@@ -142,23 +172,14 @@ void Renderer::drawMaze(const Maze &maze)
 void Renderer::drawPath(const std::vector<Point> &path,
                         const PathFinder& finder)
 {
-    const auto& grid = finder.getMaze()->getGrid();
-    auto rows = grid.size();
-    auto cells = grid[0].size();
-
-    // Calculate quad size based on window dimensions
-    float quadWidth = 2.0f / rows;
-    float quadHeight = 2.0f / cells;
+    const Maze& maze = *finder.getMaze();
+    glm::vec2 size = cellSize(maze);
 
     // Mark path
     for (const auto& p : path)
     {
-        // Calculate position in normalized device coordinates
-        float xPos = -1.0f + p.x * quadWidth + quadWidth / 2.0f;
-        float yPos = -1.0f + p.y * quadHeight + quadHeight / 2.0f;
-
-        drawQuad(glm::vec3(xPos, yPos, 0.0f),
-                 glm::vec3(quadWidth * 0.2f, quadHeight * 0.2f, 1.0f),
+        drawQuad(glm::vec3(cellCenter(maze, p), 0.0f),
+                 glm::vec3(size * 0.2f, 1.0f),
                  glm::vec3(1.0f, 1.0f, 1.0f));
     }
 }
@@ -168,9 +189,8 @@ void Renderer::visPath(const Maze& maze,
                        const std::unordered_set<Point,
                                                 PointHash>& openSet)
 {
-    const auto& grid = maze.getGrid();
-    auto rows = grid.size();
-    auto cells = grid[0].size();
+    auto rows = maze.getHeight();
+    auto cells = maze.getWidth();
 
     // Calculate quad size based on window dimensions
     float quadWidth = 2.0f / rows;
@@ -30,6 +30,11 @@ public:
                   const glm::vec3& scale,
                   const glm::vec3& color = glm::vec3(1.0f));
 
+    // Quad size of every cell and the centre of one, in normalized device
+    // coordinates. Hex mazes shift their odd rows half a cell east.
+    static glm::vec2 cellSize(const Maze& maze);
+    static glm::vec2 cellCenter(const Maze& maze, const Point& p);
+
     void drawMaze(const Maze& maze);
     void drawPath(const std::vector<Point>& path,
                   const PathFinder& finder);
@@ -0,0 +1,134 @@
+#include "scratcharena.h"
+
+#include <algorithm>
+#include <iostream>
+
+ScratchArena::Scope::Scope(ScratchArena& arena)
+    : m_arena(arena),
+      m_block(arena.m_block),
+      m_offset(arena.m_offset),
+      m_used(arena.m_used)
+{
+    m_arena.m_depth++;
+}
+
+ScratchArena::Scope::~Scope()
+{
+    m_arena.m_depth--;
+    m_arena.rewind(m_block, m_offset, m_used);
+}
+
+ScratchArena& ScratchArena::local()
+{
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+void ScratchArena::release()
+{
+    if (m_depth != 0)
+    {
+        std::cerr << "Cannot release a scratch arena inside a scope!" << std::endl;
+        return;
+    }
+
+    m_blocks = std::vector<Block>();
+    m_block = m_offset = m_used = 0;
+    m_stats.reservedBytes = 0;
+}
+
+void ScratchArena::setRetainLimit(size_t bytes)
+{
+    m_retainLimit = bytes;
+}
+
+size_t ScratchArena::getRetainLimit() const
+{
+    return m_retainLimit;
+}
+
+size_t ScratchArena::getUsedBytes() const
+{
+    return m_used;
+}
+
+const ScratchArena::Stats& ScratchArena::getStats() const
+{
+    return m_stats;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment)
+{
+    for (;;)
+    {
+        if (m_block == m_blocks.size())
+        {
+            // Doubles what the arena holds, so blocks stay few
+            addBlock(std::max({s_minBlockSize, bytes + alignment, m_stats.reservedBytes}));
+        }
+
+        Block& block = m_blocks[m_block];
+        uintptr_t at = (uintptr_t)block.data.get() + m_offset;
+        size_t padding = (alignment - at % alignment) % alignment;
+
+        if (m_offset + padding + bytes <= block.size)
+        {
+            m_offset += padding + bytes;
+            m_used += padding + bytes;
+            m_stats.peakBytes = std::max(m_stats.peakBytes, m_used);
+            return (void*)(at + padding);
+        }
+
+        // The rest of this block is skipped until the next rewind
+        m_block++;
+        m_offset = 0;
+    }
+}
+
+void ScratchArena::do_deallocate(void*, size_t, size_t)
+{
+    // Everything is handed back at once when a scope ends
+}
+
+bool ScratchArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void ScratchArena::rewind(size_t block, size_t offset, size_t used)
+{
+    m_block = block;
+    m_offset = offset;
+    m_used = used;
+
+    if (m_depth != 0)
+        return;
+
+    m_stats.scopes++;
+
+    if (m_used != 0)
+        return;
+
+    if (m_stats.reservedBytes > m_retainLimit)
+    {
+        release();
+        return;
+    }
+
+    // Nothing of the last query is left, so its blocks can become one
+    if (m_blocks.size() > 1)
+    {
+        size_t size = m_stats.reservedBytes;
+        m_blocks.clear();
+        m_stats.reservedBytes = 0;
+        addBlock(size);
+        m_block = 0;
+    }
+}
+
+void ScratchArena::addBlock(size_t size)
+{
+    m_blocks.push_back(Block{std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+    m_stats.blockAllocations++;
+    m_stats.reservedBytes += size;
+}
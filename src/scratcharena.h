@@ -0,0 +1,92 @@
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Per-thread bump allocator for the scratch memory of a search.
+// Allocating moves an offset through blocks the arena keeps, and freeing
+// does nothing. A Scope rewinds the arena when it ends, and the outermost one
+// also merges the blocks into one as large as all of them, so a repeated
+// query of the same size runs from that block without calling malloc. Past
+// the retain limit the outermost scope frees the blocks instead, so one huge
+// query does not pin its memory for the life of the thread.
+// All solvers of a thread share its arena, instead of each keeping scratch
+// arrays as large as the grid.
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+    struct Stats
+    {
+        uint64_t blockAllocations = 0; // Calls to the system allocator
+        uint64_t scopes = 0;           // Outermost scopes ended
+        size_t reservedBytes = 0;      // Held in blocks right now
+        size_t peakBytes = 0;          // Most ever handed out at once
+    };
+
+    // Rewinds the arena to where it was when the scope began. Memory taken
+    // inside a scope must not be used once it ended. Scopes nest.
+    class Scope
+    {
+    public:
+        explicit Scope(ScratchArena& arena);
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        ScratchArena& m_arena;
+        size_t m_block, m_offset, m_used;
+    };
+
+public:
+    ScratchArena() = default;
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // The arena of the calling thread
+    static ScratchArena& local();
+
+    // Frees every block, for threads done with big searches. Must not be
+    // called inside a scope.
+    void release();
+
+    // Most bytes the arena keeps once the outermost scope ends
+    void setRetainLimit(size_t bytes);
+    size_t getRetainLimit() const;
+
+    size_t getUsedBytes() const;
+    const Stats& getStats() const;
+
+protected:
+    virtual void* do_allocate(size_t bytes, size_t alignment) override;
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    void rewind(size_t block, size_t offset, size_t used);
+    void addBlock(size_t size);
+
+private:
+    static constexpr size_t s_minBlockSize = 64 * 1024;
+    static constexpr size_t s_defaultRetainLimit = 128 * 1024 * 1024;
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_block = 0;  // Block the next allocation is tried in
+    size_t m_offset = 0; // Into that block
+    size_t m_used = 0;   // Bytes handed out, padding included
+    uint32_t m_depth = 0;
+    size_t m_retainLimit = s_defaultRetainLimit;
+    Stats m_stats;
+};
+
+#endif // SCRATCHARENA_H
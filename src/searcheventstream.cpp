@@ -0,0 +1,63 @@
+#include "searcheventstream.h"
+
+SearchEventStream::Iterator::Iterator(SearchEventStream* stream)
+    : m_stream(stream)
+{
+    ++*this;
+}
+
+SearchEventStream::Iterator& SearchEventStream::Iterator::operator++()
+{
+    if (m_stream && !m_stream->next(m_event))
+        m_stream = nullptr;
+    return *this;
+}
+
+SearchEventStream::SearchEventStream(const std::shared_ptr<PathFinder>& finder,
+                                     Point start,
+                                     Point end)
+    : m_finder(finder),
+      m_end(end)
+{
+    m_finder->begin(start, end);
+}
+
+bool SearchEventStream::next(SearchEvent& event)
+{
+    // Run the search one expansion at a time until it has something to say
+    while (m_index == m_finder->getLastEvents().size())
+    {
+        if (m_finder->isFinished())
+        {
+            if (m_done)
+                return false;
+
+            m_done = true;
+            event = SearchEvent{SearchEvent::Type::Finish,
+                                m_end,
+                                (int)m_finder->getStepResult().size()};
+            return true;
+        }
+
+        m_finder->step(1);
+        m_index = 0;
+    }
+
+    event = m_finder->getLastEvents()[m_index++];
+    return true;
+}
+
+SearchEventStream::Iterator SearchEventStream::begin()
+{
+    return Iterator(this);
+}
+
+SearchEventStream::Iterator SearchEventStream::end()
+{
+    return Iterator();
+}
+
+const std::shared_ptr<PathFinder>& SearchEventStream::getFinder() const
+{
+    return m_finder;
+}
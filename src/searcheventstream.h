@@ -0,0 +1,61 @@
+#ifndef SEARCHEVENTSTREAM_H
+#define SEARCHEVENTSTREAM_H
+
+#include "pathfinder.h"
+
+#include <iterator>
+
+// Lazy, pull-based view of a search as a sequence of SearchEvents.
+// Every next() runs the solver only as far as the next event, so a consumer
+// pays for exactly what it reads and no more than one expansion's events are
+// ever buffered. The sequence always ends with a Finish event.
+// Solvers that are not resumable finish inside the constructor and only
+// produce the Finish event. The stream drives the finder, so it must not be
+// used for anything else until the stream is done with it.
+class SearchEventStream
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = SearchEvent;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const SearchEvent*;
+        using reference = const SearchEvent&;
+
+        Iterator() = default;
+        explicit Iterator(SearchEventStream* stream);
+
+        reference operator*() const { return m_event; }
+        pointer operator->() const { return &m_event; }
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return m_stream == other.m_stream; }
+        bool operator!=(const Iterator& other) const { return m_stream != other.m_stream; }
+
+    private:
+        SearchEventStream* m_stream = nullptr; // Null once past the end
+        SearchEvent m_event{};
+    };
+
+public:
+    SearchEventStream(const std::shared_ptr<PathFinder>& finder,
+                      Point start,
+                      Point end);
+
+    // Returns false once the Finish event has been handed out
+    bool next(SearchEvent& event);
+
+    Iterator begin();
+    Iterator end();
+
+    const std::shared_ptr<PathFinder>& getFinder() const;
+
+private:
+    std::shared_ptr<PathFinder> m_finder;
+    Point m_end;
+    size_t m_index = 0;
+    bool m_done = false;
+};
+
+#endif // SEARCHEVENTSTREAM_H
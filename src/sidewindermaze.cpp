@@ -0,0 +1,39 @@
+#include "sidewindermaze.h"
+
+SidewinderMaze::SidewinderMaze(uint32_t width,
+                               uint32_t height)
+    : Maze(width, height)
+{
+    m_generatorName = "Sidewinder";
+}
+
+void SidewinderMaze::onGenerate()
+{
+    int width = getWidth();
+    int height = getHeight();
+
+    for (int y = 0; y < height; y += 2)
+    {
+        int runStart = 0;
+        for (int x = 0; x < width; x += 2)
+        {
+            setWall(x, y, false);
+
+            // The first row has nothing above, so it is all one run
+            bool atEastEdge = x + 2 >= width;
+            bool closeRun = y > 0 && (atEastEdge || (m_rng() & 1));
+
+            if (closeRun)
+            {
+                int rooms = (x - runStart) / 2 + 1;
+                int up = runStart + 2 * (int)(m_rng() % rooms);
+                setWall(up, y - 1, false);
+                runStart = x + 2;
+            }
+            else if (!atEastEdge)
+            {
+                setWall(x + 1, y, false);
+            }
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef SIDEWINDERMAZE_H
+#define SIDEWINDERMAZE_H
+
+#include "maze.h"
+
+// Carves runs along each row and links every run to the row above through
+// one random cell. Visits each cell once in row order, the first row is one
+// long corridor.
+class SidewinderMaze : public Maze
+{
+public:
+    SidewinderMaze(uint32_t width = 21,
+                   uint32_t height = 21);
+
+protected:
+    virtual void onGenerate() override;
+};
+
+#endif // SIDEWINDERMAZE_H
@@ -0,0 +1,648 @@
+#ifndef SOLVERCORE_H
+#define SOLVERCORE_H
+
+#include "pathfinder.h"
+
+#include "scratcharena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory_resource>
+
+// Solver loops specialised at compile time.
+// The grid search loops are templates over four policies: how the wall bits
+// are stored, which moves the maze's topology allows, where step costs come
+// from and whether a trace is recorded. dispatch() picks the policies
+// matching a maze once per query, after which the compiler sees every wall
+// read, cost and trace hook of the loop and inlines them. With NoTrace the
+// hooks vanish.
+// The searches keep their whole state in their members, so findPath() runs
+// one to the end over the thread's ScratchArena while begin() and step()
+// run the same loop a few expansions at a time. The PathFinder helpers
+// doing either are defined at the end of this file.
+namespace SolverCore
+{
+
+constexpr uint32_t invalidCell = UINT32_MAX;
+// Returned by a search that used up its expansions, no grid has this many
+// cells
+constexpr uint32_t pausedCell = UINT32_MAX - 1;
+
+inline Point cellPoint(uint32_t cell, uint32_t width)
+{
+    return Point{(int)(cell % width), (int)(cell / width)};
+}
+
+// Grid policies. wall() takes a cell at most one step outside the grid,
+// except the one off both its west and south edge. openSides() takes a valid
+// cell and returns bit i set if the neighbour in direction i of Maze::dx/dy
+// is open.
+
+// Owned row-major storage, read unchecked thanks to its wall rows
+struct RowMajorGrid
+{
+    const uint64_t* words;
+    uint32_t rowWords;
+
+    explicit RowMajorGrid(const Maze& maze)
+        : words(maze.getWords()), rowWords(maze.getRowWords())
+    {}
+
+    bool wall(int x, int y) const
+    {
+        return (words[(ptrdiff_t)y * rowWords + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    uint8_t openSides(int x, int y) const
+    {
+        uint8_t walls = wall(x, y + 1) |
+                        wall(x + 1, y) << 1 |
+                        wall(x, y - 1) << 2 |
+                        wall(x - 1, y) << 3;
+        return ~walls & 0xf;
+    }
+};
+
+// The tiled copy of the walls, with its wall rows of tiles
+struct TiledGrid
+{
+    const uint64_t* tiles;
+    uint32_t tilesX;
+
+    explicit TiledGrid(const Maze& maze)
+        : tiles(maze.getTileWords()), tilesX(maze.getTilesPerRow())
+    {}
+
+    bool wall(int x, int y) const
+    {
+        uint64_t tile = tiles[(ptrdiff_t)(y >> 3) * tilesX + (x >> 3)];
+        return (tile >> (((y & 7) << 3) | (x & 7))) & 1;
+    }
+
+    uint8_t openSides(int x, int y) const
+    {
+        uint8_t walls = wall(x, y + 1) |
+                        wall(x + 1, y) << 1 |
+                        wall(x, y - 1) << 2 |
+                        wall(x - 1, y) << 3;
+        return ~walls & 0xf;
+    }
+};
+
+// Read-only views have no wall rows, so they go through the checked reads
+struct CheckedGrid
+{
+    const Maze* maze;
+
+    explicit CheckedGrid(const Maze& maze)
+        : maze(&maze)
+    {}
+
+    bool wall(int x, int y) const
+    {
+        return !maze->isValidCell(x, y) || maze->isWall(x, y);
+    }
+
+    uint8_t openSides(int x, int y) const
+    {
+        return maze->getOpenSides(x, y);
+    }
+};
+
+// Move policies, one per Maze::Topology. The first four moves of each are
+// those of Maze::dx/dy. open() returns bit i set if move i leads to an open
+// cell, weight(i) scales the cost of entering that cell and distance() is a
+// lower bound on the weights between two cells.
+
+// Square grid. The diagonals follow clockwise from north-east and are open
+// only if both sides they pass are, so no move cuts a corner. A diagonal
+// weighs 7/5 of a straight move, which keeps octile distances in integers.
+template <int Connectivity>
+struct SquareMoves
+{
+    static_assert(Connectivity == 4 || Connectivity == 8,
+                  "Square moves are 4 or 8-connected");
+
+    static constexpr int count = Connectivity;
+    static constexpr uint32_t straightWeight = Connectivity == 8 ? 5 : 1;
+    static constexpr uint32_t diagonalWeight = 7;
+
+    static constexpr int s_dx[] = { 0,  1,  0, -1,  1,  1, -1, -1 };
+    static constexpr int s_dy[] = { 1,  0, -1,  0,  1, -1, -1,  1 };
+
+    static int dx(int i, int) { return s_dx[i]; }
+    static int dy(int i) { return s_dy[i]; }
+    static uint32_t weight(int i) { return i < 4 ? straightWeight : diagonalWeight; }
+
+    template <class Grid>
+    static uint8_t open(const Grid& grid, int x, int y)
+    {
+        uint8_t sides = grid.openSides(x, y);
+        if constexpr (Connectivity == 8)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                int a = i, b = (i + 1) & 3;
+                if ((sides >> a & 1) && (sides >> b & 1) &&
+                    !grid.wall(x + s_dx[a] + s_dx[b], y + s_dy[a] + s_dy[b]))
+                    sides |= 1 << (4 + i);
+            }
+        }
+        return sides;
+    }
+
+    // Manhattan, or octile with the diagonal weight
+    static int distance(const Point& a, const Point& b)
+    {
+        int ax = std::abs(a.x - b.x);
+        int ay = std::abs(a.y - b.y);
+        if constexpr (Connectivity == 8)
+        {
+            return (int)straightWeight * std::abs(ax - ay) +
+                   (int)diagonalWeight * std::min(ax, ay);
+        }
+        return ax + ay;
+    }
+};
+
+// Hex grid in offset rows, every odd row sits half a cell east. Moves 4 and
+// 5 are the other neighbours above and below: east of x on odd rows and
+// west of it on even rows.
+struct HexMoves
+{
+    static constexpr int count = 6;
+
+    static int side(int y) { return (y & 1) ? 1 : -1; }
+    static int dx(int i, int y) { return i < 4 ? Maze::dx[i] : side(y); }
+    static int dy(int i) { return i < 4 ? Maze::dy[i] : (i == 4 ? 1 : -1); }
+    static uint32_t weight(int) { return 1; }
+
+    template <class Grid>
+    static uint8_t open(const Grid& grid, int x, int y)
+    {
+        uint8_t sides = grid.openSides(x, y);
+
+        // West of column 0 is a wall, and below row 0 not even a wall row
+        int sx = x + side(y);
+        if (sx >= 0)
+        {
+            sides |= !grid.wall(sx, y + 1) << 4;
+            sides |= !grid.wall(sx, y - 1) << 5;
+        }
+        return sides;
+    }
+
+    // Steps in cube coordinates
+    static int distance(const Point& a, const Point& b)
+    {
+        int dq = (a.x - (a.y >> 1)) - (b.x - (b.y >> 1));
+        int dr = a.y - b.y;
+        return (std::abs(dq) + std::abs(dr) + std::abs(dq + dr)) / 2;
+    }
+};
+
+// Calls fn with the move policy of a topology
+template <class Fn>
+decltype(auto) withMoves(Maze::Topology topology, Fn&& fn)
+{
+    switch (topology)
+    {
+    case Maze::Topology::Square8: return fn(SquareMoves<8>());
+    case Maze::Topology::Hex:     return fn(HexMoves());
+    default:                      return fn(SquareMoves<4>());
+    }
+}
+
+// Cost models, the cost of entering a cell
+
+struct UnitCost
+{
+    uint32_t operator()(uint32_t) const { return 1; }
+};
+
+struct LayerCost
+{
+    const uint8_t* costs;
+
+    uint32_t operator()(uint32_t cell) const { return costs[cell]; }
+};
+
+// Trace policies. expand() starts an iteration, discover() adds to it and
+// commit() closes it once the cell is fully expanded.
+
+struct NoTrace
+{
+    void expand(uint32_t) {}
+    void discover(uint32_t, int) {}
+    template <class Parents>
+    void commit(const Parents&, uint32_t, uint32_t) {}
+};
+
+// The route from start to current along cameFrom, empty if current does not
+// lead to start
+template <class Parents>
+std::vector<Point> reconstruct(const Parents& cameFrom,
+                               uint32_t current,
+                               uint32_t start,
+                               uint32_t width)
+{
+    // Count the steps first so the path is allocated exactly once
+    size_t length = 1;
+    uint32_t cell = current;
+    while (cell != start && cameFrom[cell] != invalidCell)
+    {
+        cell = cameFrom[cell];
+        length++;
+    }
+
+    if (cell != start)
+        return std::vector<Point>();
+
+    std::vector<Point> path(length);
+    for (size_t i = length; i-- > 0; current = cameFrom[current])
+    {
+        path[i] = cellPoint(current, width);
+    }
+
+    return path;
+}
+
+// The IterationData findPath() returns, one per expanded cell
+struct FullTrace
+{
+    std::vector<IterationData>& iterations;
+    uint32_t width;
+    IterationData current;
+
+    FullTrace(std::vector<IterationData>& iterations, uint32_t width)
+        : iterations(iterations), width(width)
+    {}
+
+    void expand(uint32_t cell)
+    {
+        current = IterationData();
+        current.currentPoint = cellPoint(cell, width);
+    }
+
+    void discover(uint32_t cell, int value)
+    {
+        current.neighbors[cellPoint(cell, width)] = value;
+    }
+
+    template <class Parents>
+    void commit(const Parents& cameFrom, uint32_t cell, uint32_t start)
+    {
+        current.path = reconstruct(cameFrom, cell, start, width);
+        iterations.push_back(std::move(current));
+    }
+};
+
+// The SearchEvents of a stepped search, the route to each cell is left
+// to PathFinder::getLastStep()
+struct EventTrace
+{
+    std::vector<SearchEvent>& events;
+    uint32_t width;
+
+    void expand(uint32_t cell)
+    {
+        events.push_back(SearchEvent{SearchEvent::Type::Expand, cellPoint(cell, width)});
+    }
+
+    void discover(uint32_t cell, int value)
+    {
+        events.push_back(SearchEvent{SearchEvent::Type::Discover, cellPoint(cell, width), value});
+    }
+
+    template <class Parents>
+    void commit(const Parents&, uint32_t, uint32_t) {}
+};
+
+// Open sets for BestFirst, lowest key first
+
+// BucketQueue has the interface already, this gives the binary heap the same
+struct HeapQueue
+{
+    std::pmr::vector<std::pair<uint32_t, uint32_t>> heap;
+
+    explicit HeapQueue(std::pmr::memory_resource* resource =
+                           std::pmr::get_default_resource())
+        : heap(resource)
+    {}
+
+    static bool compare(const std::pair<uint32_t, uint32_t>& a,
+                        const std::pair<uint32_t, uint32_t>& b)
+    {
+        return a.first > b.first;
+    }
+
+    void clear() { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+
+    void push(uint32_t key, uint32_t item)
+    {
+        heap.push_back({key, item});
+        std::push_heap(heap.begin(), heap.end(), compare);
+    }
+
+    std::pair<uint32_t, uint32_t> pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        auto top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+};
+
+// Calls fn(grid, cost, moves) with the policies matching the maze. Unless
+// Weighted, every step costs 1 whatever the cost layer says.
+template <bool Weighted, class Fn>
+void dispatch(const Maze& maze, Fn&& fn)
+{
+    auto withCost = [&](const auto& grid)
+    {
+        auto withGrid = [&](const auto& cost)
+        {
+            withMoves(maze.getTopology(), [&](auto moves)
+            {
+                fn(grid, cost, moves);
+            });
+        };
+
+        if constexpr (Weighted)
+        {
+            if (maze.hasCosts())
+            {
+                withGrid(LayerCost{maze.getCosts()});
+                return;
+            }
+        }
+        withGrid(UnitCost());
+    };
+
+    if (maze.getLayout() == Maze::Layout::Tiled)
+        withCost(TiledGrid(maze));
+    else if (!maze.isReadOnly())
+        withCost(RowMajorGrid(maze));
+    else
+        withCost(CheckedGrid(maze));
+}
+
+// Searches. begin() sets one up from start to end and run() expands cells
+// until it reaches the end, runs out of cells, stop() says so or it has
+// expanded budget cells. run() returns the end, invalidCell if there is no
+// path, the cell it was about to expand when stop() said so, or pausedCell
+// when the budget ran out, after which the next run() carries on. stop() is
+// asked before every expansion. The buffers come from the resource given
+// and keep their capacity between searches.
+
+// Breadth-first, or depth-first with a LIFO frontier. Both ignore costs.
+template <bool Lifo>
+struct Uninformed
+{
+    static constexpr bool weighted = false;
+
+    std::pmr::vector<uint32_t> frontier;
+    std::pmr::vector<uint32_t> cameFrom; // The start is its own parent
+    size_t head = 0;                     // Next cell of a queue, a stack pops its back
+    uint32_t width = 0;
+    uint32_t startCell = invalidCell;
+    uint32_t endCell = invalidCell;
+
+    explicit Uninformed(std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource())
+        : frontier(resource), cameFrom(resource)
+    {}
+
+    void begin(const Maze& maze, uint32_t start, uint32_t end)
+    {
+        size_t cells = (size_t)maze.getWidth() * maze.getHeight();
+        width = maze.getWidth();
+        startCell = start;
+        endCell = end;
+
+        // Every cell is queued at most once, so the frontier never reallocates
+        cameFrom.assign(cells, invalidCell);
+        frontier.clear();
+        frontier.reserve(cells);
+        frontier.push_back(start);
+        head = 0;
+        cameFrom[start] = start;
+    }
+
+    template <class Grid, class Moves, class Cost, class Trace, class Stop>
+    uint32_t run(const Grid& grid, Moves, const Cost&, Trace& trace, Stop&& stop,
+                 uint64_t budget)
+    {
+        for (uint64_t expanded = 0; head != frontier.size(); expanded++)
+        {
+            if (expanded == budget)
+                return pausedCell;
+
+            uint32_t current;
+            if constexpr (Lifo)
+            {
+                current = frontier.back();
+                frontier.pop_back();
+            }
+            else
+            {
+                current = frontier[head++];
+            }
+
+            if (current == endCell || stop())
+                return current;
+
+            trace.expand(current);
+
+            int x = (int)(current % width);
+            int y = (int)(current / width);
+            uint8_t open = Moves::open(grid, x, y);
+
+            for (int i = 0; i < Moves::count; i++)
+            {
+                if (!(open & (1 << i)))
+                    continue;
+
+                uint32_t next = (uint32_t)(y + Moves::dy(i)) * width +
+                                (uint32_t)(x + Moves::dx(i, y));
+                if (cameFrom[next] == invalidCell)
+                {
+                    frontier.push_back(next);
+                    cameFrom[next] = current;
+                    trace.discover(next, 1);
+                }
+            }
+
+            trace.commit(cameFrom, current, startCell);
+        }
+
+        return invalidCell;
+    }
+};
+
+// A* with Informed, else Dijkstra. Open is HeapQueue or BucketQueue. A step
+// costs the cell entered times the weight of the move. The heuristic is the
+// weighted steps left times the cheapest cell, admissible and consistent.
+// The trace sees f-scores.
+template <class Open, bool Informed>
+struct BestFirst
+{
+    static constexpr bool weighted = true;
+
+    Open open;
+    std::pmr::vector<uint32_t> g;        // Cost so far of every cell
+    std::pmr::vector<uint32_t> cameFrom; // The start is its own parent
+    uint32_t width = 0;
+    uint32_t startCell = invalidCell;
+    uint32_t endCell = invalidCell;
+    Point goal = { 0, 0 };
+    uint32_t scale = 0;
+
+    explicit BestFirst(std::pmr::memory_resource* resource =
+                           std::pmr::get_default_resource())
+        : open(resource), g(resource), cameFrom(resource)
+    {}
+
+    template <class Moves>
+    uint32_t heuristic(const Point& p) const
+    {
+        if constexpr (Informed)
+            return (uint32_t)Moves::distance(p, goal) * scale;
+        return 0;
+    }
+
+    void begin(const Maze& maze, uint32_t start, uint32_t end)
+    {
+        size_t cells = (size_t)maze.getWidth() * maze.getHeight();
+        width = maze.getWidth();
+        startCell = start;
+        endCell = end;
+        goal = cellPoint(end, width);
+        scale = maze.getMinCost();
+
+        g.assign(cells, UINT32_MAX);
+        cameFrom.assign(cells, invalidCell);
+        open.clear();
+        open.push(withMoves(maze.getTopology(), [&](auto moves)
+        {
+            return heuristic<decltype(moves)>(cellPoint(start, width));
+        }), start);
+        g[start] = 0;
+        cameFrom[start] = start;
+    }
+
+    template <class Grid, class Moves, class Cost, class Trace, class Stop>
+    uint32_t run(const Grid& grid, Moves, const Cost& cost, Trace& trace, Stop&& stop,
+                 uint64_t budget)
+    {
+        uint64_t expanded = 0;
+        while (!open.empty())
+        {
+            if (expanded == budget)
+                return pausedCell;
+
+            auto [f, current] = open.pop();
+            Point p = cellPoint(current, width);
+
+            // Lazy deletion, a better route to this cell was queued after this one
+            if (f != g[current] + heuristic<Moves>(p))
+                continue;
+
+            if (current == endCell || stop())
+                return current;
+
+            expanded++;
+            trace.expand(current);
+
+            uint8_t sides = Moves::open(grid, p.x, p.y);
+            for (int i = 0; i < Moves::count; i++)
+            {
+                if (!(sides & (1 << i)))
+                    continue;
+
+                Point n = Point{p.x + Moves::dx(i, p.y), p.y + Moves::dy(i)};
+                uint32_t next = (uint32_t)n.y * width + (uint32_t)n.x;
+                uint32_t tentative = g[current] + cost(next) * Moves::weight(i);
+
+                if (tentative < g[next])
+                {
+                    cameFrom[next] = current;
+                    g[next] = tentative;
+                    uint32_t nextF = tentative + heuristic<Moves>(n);
+                    open.push(nextF, next);
+                    trace.discover(next, (int)nextF);
+                }
+            }
+
+            trace.commit(cameFrom, current, startCell);
+        }
+
+        return invalidCell;
+    }
+};
+
+} // namespace SolverCore
+
+template <class Search>
+std::pair<std::vector<Point>, std::vector<IterationData>>
+PathFinder::findCorePath(Point start, Point end)
+{
+    std::vector<IterationData> iterData;
+    if (!beginCoreSearch(start, end))
+        return std::make_pair(std::vector<Point>(), std::move(iterData));
+
+    // Scratch for this search only, handed back to the arena on return
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    Search search(&arena);
+    search.begin(*m_maze, m_startCell, m_endCell);
+
+    uint32_t last = SolverCore::invalidCell;
+    SolverCore::dispatch<Search::weighted>(*m_maze,
+        [&](const auto& grid, const auto& cost, auto moves)
+        {
+            auto stop = [this] { return shouldStop(); };
+            if (isTraceEnabled())
+            {
+                SolverCore::FullTrace trace(iterData, m_maze->getWidth());
+                last = search.run(grid, moves, cost, trace, stop, UINT64_MAX);
+            }
+            else
+            {
+                SolverCore::NoTrace trace;
+                last = search.run(grid, moves, cost, trace, stop, UINT64_MAX);
+            }
+        });
+
+    return std::make_pair(finishCoreSearch(last, search.cameFrom), std::move(iterData));
+}
+
+template <class Search>
+bool PathFinder::beginCoreSteps(Search& search, Point start, Point end)
+{
+    if (!setEndpoints(start, end))
+        return false;
+
+    search.begin(*m_maze, m_startCell, m_endCell);
+    m_stepParents = &search.cameFrom;
+    return true;
+}
+
+template <class Search>
+void PathFinder::stepCore(Search& search, uint64_t maxExpansions)
+{
+    uint32_t last = SolverCore::invalidCell;
+    SolverCore::dispatch<Search::weighted>(*m_maze,
+        [&](const auto& grid, const auto& cost, auto moves)
+        {
+            SolverCore::EventTrace trace{m_events, m_maze->getWidth()};
+            last = search.run(grid, moves, cost, trace,
+                              [this] { return shouldStop(); }, maxExpansions);
+        });
+
+    if (last != SolverCore::pausedCell)
+        finish(finishCoreSearch(last, search.cameFrom));
+}
+
+#endif // SOLVERCORE_H
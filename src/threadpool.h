@@ -0,0 +1,47 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that all run the same task together.
+// Meant for level-synchronous algorithms that split each step across threads
+// and wait for every part before moving on.
+class ThreadPool
+{
+public:
+    using Task = std::function<void(unsigned index, unsigned count)>;
+
+public:
+    // Zero picks std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threadCount = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    // Number of threads a task runs on, the calling thread included
+    unsigned size() const;
+
+    // Runs task on every thread, the caller taking index 0, and returns once
+    // all of them have finished
+    void run(const Task& task);
+
+private:
+    void workerLoop(unsigned index);
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const Task* m_task = nullptr;
+    uint64_t m_generation = 0;
+    unsigned m_pending = 0;
+    bool m_stop = false;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,74 @@
+#include "treepathfinder.h"
+
+TreePathFinder::TreePathFinder() {}
+
+std::pair<std::vector<Point>, std::vector<IterationData>>
+TreePathFinder::findPath(Point start, Point end)
+{
+    beginSearch();
+
+    if (!hasIndex())
+    {
+        m_fallback.setMaze(getMaze());
+        m_fallback.setSearchLimits(getSearchLimits());
+        m_fallback.setTraceEnabled(isTraceEnabled());
+        auto result = m_fallback.findPath(start, end);
+        setLastStatus(m_fallback.getLastStatus());
+        return result;
+    }
+
+    if (!isOpen(start) || !isOpen(end))
+    {
+        return std::make_pair(std::vector<Point>(),
+                              std::vector<IterationData>());
+    }
+
+    const auto& index = getMaze()->getTreeIndex();
+    auto cells = index.path(index.cellIndex(start.x, start.y),
+                            index.cellIndex(end.x, end.y));
+    if (!cells.empty())
+        setLastStatus(SearchStatus::Found);
+
+    // There is no search to visualize, the path is read off the tree
+    std::vector<Point> path;
+    path.reserve(cells.size());
+    for (uint32_t cell : cells)
+    {
+        path.push_back(Point{(int)(cell % getMaze()->getWidth()),
+                             (int)(cell / getMaze()->getWidth())});
+    }
+
+    return std::make_pair(path, std::vector<IterationData>());
+}
+
+int TreePathFinder::distance(Point start, Point end)
+{
+    if (!hasIndex())
+    {
+        m_fallback.setMaze(getMaze());
+        m_fallback.setSearchLimits(getSearchLimits());
+        m_fallback.setTraceEnabled(false);
+        auto path = m_fallback.findPath(start, end).first;
+        return path.empty() ? -1 : (int)path.size() - 1;
+    }
+
+    if (!isOpen(start) || !isOpen(end))
+        return -1;
+
+    const auto& index = getMaze()->getTreeIndex();
+    uint32_t d = index.distance(index.cellIndex(start.x, start.y),
+                                index.cellIndex(end.x, end.y));
+    return d == MazeTreeIndex::invalid ? -1 : (int)d;
+}
+
+bool TreePathFinder::hasIndex() const
+{
+    const auto& index = getMaze()->getTreeIndex();
+    return index.isBuilt() && index.isTree();
+}
+
+bool TreePathFinder::isOpen(const Point &p) const
+{
+    return getMaze()->isValidCell(p.x, p.y) &&
+           !getMaze()->isWall(p.x, p.y);
+}
@@ -0,0 +1,29 @@
+#ifndef TREEPATHFINDER_H
+#define TREEPATHFINDER_H
+
+#include "pathfinder.h"
+#include "bfspathfinder.h"
+
+// Answers queries from the maze's tree index instead of searching.
+// Falls back to BFS when the grid is not a perfect maze.
+class TreePathFinder : public PathFinder
+{
+public:
+    TreePathFinder();
+
+    virtual
+    std::pair<std::vector<Point>, std::vector<IterationData>>
+    findPath(Point start, Point end) override;
+
+    // Number of moves on the path, -1 if the cells are not connected
+    int distance(Point start, Point end);
+
+private:
+    bool hasIndex() const;
+    bool isOpen(const Point& p) const;
+
+private:
+    BFSPathFinder m_fallback;
+};
+
+#endif // TREEPATHFINDER_H
@@ -0,0 +1,82 @@
+#include "wilsonmaze.h"
+
+WilsonMaze::WilsonMaze(uint32_t width,
+                       uint32_t height)
+    : Maze(width, height)
+{
+    m_generatorName = "Wilson";
+}
+
+void WilsonMaze::onGenerate()
+{
+    int cols = (getWidth() + 1) / 2;
+    int rows = (getHeight() + 1) / 2;
+    uint32_t roomCount = (uint32_t)cols * rows;
+
+    // Two bits of a 32-bit draw per step
+    uint32_t bits = 0, bitsLeft = 0;
+    auto randomDir = [&](int cx, int cy)
+    {
+        for (;;)
+        {
+            if (bitsLeft == 0)
+            {
+                bits = m_rng();
+                bitsLeft = 16;
+            }
+            uint8_t dir = bits & 3;
+            bits >>= 2;
+            bitsLeft--;
+
+            int nx = cx + dx[dir];
+            int ny = cy + dy[dir];
+            if (nx >= 0 && nx < cols && ny >= 0 && ny < rows)
+                return dir;
+        }
+    };
+
+    // Rooms are open once they are in the maze
+    auto inMaze = [this](int cx, int cy)
+    {
+        return !isWall(cx * 2, cy * 2);
+    };
+
+    // The first room is the root every walk ends up joining
+    int cx = (int)(m_rng() % cols);
+    int cy = (int)(m_rng() % rows);
+    setWall(cx * 2, cy * 2, false);
+
+    // Direction each room was last left by, the loop-erased walk
+    m_exitDir.assign(roomCount, 0);
+
+    for (int sy = 0; sy < rows; sy++)
+    {
+        for (int sx = 0; sx < cols; sx++)
+        {
+            if (inMaze(sx, sy))
+                continue;
+
+            cx = sx;
+            cy = sy;
+            while (!inMaze(cx, cy))
+            {
+                uint8_t dir = randomDir(cx, cy);
+                m_exitDir[(size_t)cy * cols + cx] = dir;
+                cx += dx[dir];
+                cy += dy[dir];
+            }
+
+            // Follow the last exits from the start, which skips every loop
+            cx = sx;
+            cy = sy;
+            while (!inMaze(cx, cy))
+            {
+                uint8_t dir = m_exitDir[(size_t)cy * cols + cx];
+                setWall(cx * 2, cy * 2, false);
+                setWall(cx * 2 + dx[dir], cy * 2 + dy[dir], false);
+                cx += dx[dir];
+                cy += dy[dir];
+            }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef WILSONMAZE_H
+#define WILSONMAZE_H
+
+#include "maze.h"
+
+// Wilson's algorithm, which picks uniformly among all spanning trees of the
+// rooms. Unbiased mazes have no preferred direction or corridor length, the
+// other generators all show some bias.
+// Random walks start from rooms outside the maze and are joined to it once
+// they hit it. Only the direction of the last exit from each room is kept, so
+// loops are erased by overwriting a byte.
+class WilsonMaze : public Maze
+{
+public:
+    WilsonMaze(uint32_t width = 21,
+               uint32_t height = 21);
+
+protected:
+    virtual void onGenerate() override;
+
+private:
+    std::vector<uint8_t> m_exitDir; // Per room, kept between calls
+};
+
+#endif // WILSONMAZE_H
@@ -0,0 +1,98 @@
+// A warm findPath() with the trace off must allocate nothing but the path it
+// returns, however many cells it expands. Global operator new is replaced to
+// count every allocation the query makes.
+
+#include "kruskalmaze.h"
+#include "bfspathfinder.h"
+#include "dfspathfinder.h"
+#include "astarpathfinder.h"
+#include "dijkstrapathfinder.h"
+#include "bitbfspathfinder.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+static uint64_t s_allocations = 0;
+
+void* operator new(size_t size)
+{
+    s_allocations++;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+static bool checkSolver(const char* name,
+                        PathFinder& finder,
+                        const std::shared_ptr<Maze>& maze,
+                        Point start,
+                        Point end)
+{
+    finder.setMaze(maze);
+    finder.setTraceEnabled(false);
+
+    // The first queries grow the scratch buffers and the thread's arena
+    finder.findPath(start, end);
+    finder.findPath(start, end);
+
+    uint64_t before = s_allocations;
+    auto result = finder.findPath(start, end);
+    uint64_t allocations = s_allocations - before;
+
+    if (result.first.empty() || !result.second.empty())
+    {
+        std::cerr << name << ": expected a path and no trace" << std::endl;
+        return false;
+    }
+
+    if (allocations != 1)
+    {
+        std::cerr << name << ": " << allocations
+                  << " allocations, expected 1 for the path" << std::endl;
+        return false;
+    }
+
+    std::cout << name << ": 1 allocation over "
+              << finder.getLastExpansions() << " expansions" << std::endl;
+    return true;
+}
+
+int main()
+{
+    // Loops and costs, so the searches expand far more than the path
+    auto maze = std::make_shared<KruskalMaze>(201, 201);
+    maze->setBraidRatio(0.5f);
+    maze->generate(1);
+    maze->randomizeCosts(9, 1);
+
+    Point start = { 0, 0 };
+    Point end = { 200, 200 };
+
+    BFSPathFinder bfs;
+    DFSPathFinder dfs;
+    AStarPathFinder heap(AStarPathFinder::QueueType::BinaryHeap);
+    AStarPathFinder buckets(AStarPathFinder::QueueType::Buckets);
+    DijkstraPathFinder dijkstra;
+    BitBFSPathFinder bitBfs;
+
+    bool ok = true;
+    ok &= checkSolver("BFS", bfs, maze, start, end);
+    ok &= checkSolver("DFS", dfs, maze, start, end);
+    ok &= checkSolver("A* (binary heap)", heap, maze, start, end);
+    ok &= checkSolver("A* (buckets)", buckets, maze, start, end);
+    ok &= checkSolver("Dijkstra", dijkstra, maze, start, end);
+    ok &= checkSolver("Bit-parallel BFS", bitBfs, maze, start, end);
+
+    return ok ? 0 : 1;
+}